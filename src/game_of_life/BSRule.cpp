@@ -0,0 +1,82 @@
+/*
+ *  Author: Abraham Cardenas / https://github.com/Abe-Crdns
+ */
+
+#ifndef _BS_RULE_CPP
+#define _BS_RULE_CPP
+
+#include <cctype>
+#include "BSRule.h"
+
+bool BSRule::operator==(const BSRule& other) const{
+  return birth == other.birth && survive == other.survive;
+}
+
+bool BSRule::operator!=(const BSRule& other) const{
+  return !(*this == other);
+}
+
+BSRule conwayRule(){
+  return {1 << 3, (1 << 2) | (1 << 3)};
+}
+
+BSRule ruleFromIndex(unsigned index){
+  return {(uint16_t)(index & 0x1FF), (uint16_t)((index >> 9) & 0x1FF)};
+}
+
+unsigned ruleIndex(BSRule rule){
+  return rule.birth | ((unsigned)rule.survive << 9);
+}
+
+unsigned ruleCounts(BSRule rule){
+  return rule.birth | rule.survive;
+}
+
+// Digits 0 to 8 from text[start] up to text[end], as a mask
+static bool parseCounts(const std::string& text, size_t start, size_t end, uint16_t* counts){
+  *counts = 0;
+  for(size_t i = start; i < end; ++i){
+    if(text[i] < '0' || text[i] > '8')
+      return false;
+    *counts |= 1 << (text[i] - '0');
+  }
+  return true;
+}
+
+bool parseRule(std::string text, BSRule* rule){
+  for(size_t i = 0; i < text.size(); ++i)
+    text[i] = toupper(text[i]);
+
+  size_t slash = text.find('/');
+  if(slash == std::string::npos)
+    return false;
+
+  std::string first = text.substr(0, slash), second = text.substr(slash + 1);
+  bool b_first = !first.empty() && first[0] == 'B' && !second.empty() && second[0] == 'S';
+  bool s_first = !first.empty() && first[0] == 'S' && !second.empty() && second[0] == 'B';
+
+  if(b_first)
+    return parseCounts(first, 1, first.size(), &rule->birth) &&
+           parseCounts(second, 1, second.size(), &rule->survive);
+  if(s_first)
+    return parseCounts(first, 1, first.size(), &rule->survive) &&
+           parseCounts(second, 1, second.size(), &rule->birth);
+  return parseCounts(first, 0, first.size(), &rule->survive) &&
+         parseCounts(second, 0, second.size(), &rule->birth);
+}
+
+std::string ruleName(BSRule rule){
+  std::string name = "B";
+  for(unsigned n = 0; n <= 8; ++n){
+    if(rule.birth & (1 << n))
+      name += (char)('0' + n);
+  }
+  name += "/S";
+  for(unsigned n = 0; n <= 8; ++n){
+    if(rule.survive & (1 << n))
+      name += (char)('0' + n);
+  }
+  return name;
+}
+
+#endif
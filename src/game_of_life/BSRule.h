@@ -0,0 +1,35 @@
+#ifndef _BS_RULE_H
+#define _BS_RULE_H
+
+#include <cstdint>
+#include <string>
+
+// Outer-totalistic rules over 0 to 8 neighbors, 2^18 of them
+#define BS_RULE_COUNT (1u << 18)
+
+// A Life-like rule: bit n of birth is set when a dead cell with n live
+// neighbors comes alive, bit n of survive when a live one stays alive
+struct BSRule {
+  uint16_t birth, survive;
+  bool operator==(const BSRule& other) const;
+  bool operator!=(const BSRule& other) const;
+};
+
+// B3/S23
+BSRule conwayRule();
+
+// Rule number index, birth in the low 9 bits and survive above them
+BSRule ruleFromIndex(unsigned index);
+unsigned ruleIndex(BSRule rule);
+
+// Neighbor counts the rule looks at, birth and survive together
+unsigned ruleCounts(BSRule rule);
+
+// Reads "B36/S23" or the older survive-first "23/36", case aside.
+// Returns false if the text isn't a rule.
+bool parseRule(std::string text, BSRule* rule);
+
+// "B36/S23"
+std::string ruleName(BSRule rule);
+
+#endif
@@ -0,0 +1,526 @@
+/*
+ *  Author: Abraham Cardenas / https://github.com/Abe-Crdns
+ */
+
+#ifndef _BATCH_RUN_CPP
+#define _BATCH_RUN_CPP
+
+#include <algorithm>
+#include <iostream>
+#include <climits>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include "../lpc_lib/lpclib.h"
+#include "BatchRun.h"
+#include "Checkpoint.h"
+#include "ComponentLabeler.h"
+#include "KeyframeIndex.h"
+#include "ObjectTracker.h"
+#include "PatternCatalog.h"
+#include "PatternFile.h"
+#include "StatsStream.h"
+#include "SymmetricBoard.h"
+#include "private/Timer.h"
+#include "private/WorkerPool.h"
+
+static void printUsage(const char* prog){
+  std::cerr << "usage: " << prog << " --pattern <file> [options]\n"
+            << "  --pattern <file>             pattern to load (.rle, .mc, .cells, .snap)\n"
+            << "  --region <row>,<col>         load only the --rows x --cols window of a .mc pattern\n"
+            << "  --gens <n>                   generations to run (default 0)\n"
+            << "  --threads <n>                stepping threads (default: all cores)\n"
+            << "  --out <file>                 write the final board here\n"
+            << "  --rows <n>                   board rows (default: pattern height)\n"
+            << "  --cols <n>                   board columns (default: pattern width)\n"
+            << "  --bound <scheme>             flat, donut or mirror (default flat)\n"
+            << "  --restore <file>             start from a checkpoint instead of a pattern\n"
+            << "  --checkpoint <file>          write a .snap base and its .deltas here\n"
+            << "  --checkpoint-every <n>       generations between deltas (default 1000)\n"
+            << "  --checkpoint-budget <MB/s>   average write rate to stay under\n"
+            << "  --keyframes <prefix>         record (or seek through) <prefix>.index\n"
+            << "  --keyframe-every <n>         generations between keyframes (default 10000)\n"
+            << "  --seek <gen>                 start at this generation using the keyframes\n"
+            << "  --stats <file>               per-generation statistics, - for stdout\n"
+            << "  --stats-format <format>      csv or binary (default csv)\n"
+            << "  --catalog <dir>              pattern catalog to stamp from\n"
+            << "  --stamp <name>@<row>,<col>   stamp a catalog pattern, can be repeated\n"
+            << "  --objects <n>                label the final board's objects, list the n largest\n"
+            << "  --track <period>             classify objects every generation, up to this period\n"
+            << "  --symmetry <auto|lr|tb|d4>   step only the fundamental domain of a symmetric board\n"
+            << "  --window <row>,<col>,<h>x<w> step only what reaches this window, write just it out\n";
+}
+
+unsigned long long parseCount(std::string opt, std::string val){
+  char* end = nullptr;
+  unsigned long long count = strtoull(val.c_str(), &end, 10);
+
+  if(val.empty() || *end != '\0' || val[0] == '-')
+    Error("Bad value for " + opt + ": " + val);
+
+  return count;
+}
+
+static BoundaryScheme parseBoundScheme(std::string val){
+  std::string scheme = ConvertToLowerCase(val);
+
+  if(scheme == "flat")
+    return Flat;
+  else if(scheme == "donut")
+    return Donut;
+  else if(scheme == "mirror")
+    return Mirror;
+
+  Error("Bad value for --bound: " + val);
+}
+
+// A row,col,rowsxcols window, its top left corner and size
+static ConeWindow parseWindow(std::string val){
+  const char* seps = ",,x";
+  unsigned fields[4];
+  const char* pos = val.c_str();
+
+  for(unsigned f = 0; f < 4; ++f){
+    char* end = nullptr;
+    fields[f] = (*pos >= '0' && *pos <= '9') ? strtoul(pos, &end, 10) : 0;
+    if(end == nullptr || *end != (f < 3 ? seps[f] : '\0'))
+      Error("Bad value for --window: " + val);
+    pos = end + 1;
+  }
+
+  ConeWindow window;
+  window.top = fields[0];
+  window.left = fields[1];
+  window.rows = fields[2];
+  window.cols = fields[3];
+  return window;
+}
+
+static bool parseOptions(int argc, char* argv[], BatchOptions* opts){
+  opts->load_region = false;
+  opts->region_top = 0;
+  opts->region_left = 0;
+  opts->gens = 0;
+  opts->threads = std::thread::hardware_concurrency();
+  opts->rows = 0;
+  opts->cols = 0;
+  opts->bound_scheme = Flat;
+  opts->checkpoint_every = 1000;
+  opts->checkpoint_budget = 0;
+  opts->keyframe_every = 10000;
+  opts->seek_gen = 0;
+  opts->seek = false;
+  opts->label_objects = false;
+  opts->objects_listed = 0;
+  opts->track_period = 0;
+  opts->query_window = false;
+  opts->stats_binary = false;
+
+  if(opts->threads == 0)
+    opts->threads = 1;
+
+  for(int i = 1; i < argc; ++i){
+    std::string opt = argv[i];
+
+    if(i + 1 >= argc){
+      std::cerr << "Missing value for " << opt << std::endl;
+      return false;
+    }
+    std::string val = argv[++i];
+
+    if(opt == "--pattern")
+      opts->pattern_file = val;
+    else if(opt == "--out")
+      opts->out_file = val;
+    else if(opt == "--gens")
+      opts->gens = parseCount(opt, val);
+    else if(opt == "--threads")
+      opts->threads = parseCount(opt, val);
+    else if(opt == "--rows")
+      opts->rows = parseCount(opt, val);
+    else if(opt == "--cols")
+      opts->cols = parseCount(opt, val);
+    else if(opt == "--bound")
+      opts->bound_scheme = parseBoundScheme(val);
+    else if(opt == "--restore")
+      opts->restore_file = val;
+    else if(opt == "--checkpoint")
+      opts->checkpoint_file = val;
+    else if(opt == "--checkpoint-every")
+      opts->checkpoint_every = parseCount(opt, val);
+    else if(opt == "--checkpoint-budget")
+      opts->checkpoint_budget = parseCount(opt, val) * 1e6;
+    else if(opt == "--keyframes")
+      opts->keyframe_prefix = val;
+    else if(opt == "--keyframe-every")
+      opts->keyframe_every = parseCount(opt, val);
+    else if(opt == "--stats")
+      opts->stats_file = val;
+    else if(opt == "--catalog")
+      opts->catalog_dir = val;
+    else if(opt == "--stamp")
+      opts->stamps.push_back(val);
+    else if(opt == "--stats-format"){
+      std::string format = ConvertToLowerCase(val);
+      if(format != "csv" && format != "binary")
+        Error("Bad value for --stats-format: " + val);
+      opts->stats_binary = (format == "binary");
+    }
+    else if(opt == "--objects"){
+      opts->objects_listed = parseCount(opt, val);
+      opts->label_objects = true;
+    }
+    else if(opt == "--track")
+      opts->track_period = parseCount(opt, val);
+    else if(opt == "--symmetry"){
+      opts->symmetry = ConvertToLowerCase(val);
+      if(opts->symmetry != "auto" && opts->symmetry != "lr" &&
+         opts->symmetry != "tb" && opts->symmetry != "d4")
+        Error("Bad value for --symmetry: " + val);
+    }
+    else if(opt == "--region"){
+      size_t comma = val.find(',');
+      if(comma == std::string::npos)
+        Error("Bad value for --region: " + val);
+      opts->region_top = parseCount(opt, val.substr(0, comma));
+      opts->region_left = parseCount(opt, val.substr(comma + 1));
+      if(opts->region_top > LLONG_MAX || opts->region_left > LLONG_MAX)
+        Error("Bad value for --region: " + val);
+      opts->load_region = true;
+    }
+    else if(opt == "--window"){
+      opts->window = parseWindow(val);
+      opts->query_window = true;
+    }
+    else if(opt == "--seek"){
+      opts->seek_gen = parseCount(opt, val);
+      opts->seek = true;
+    }
+    else{
+      std::cerr << "Unknown option " << opt << std::endl;
+      return false;
+    }
+  }
+
+  int sources = !opts->pattern_file.empty() + !opts->restore_file.empty() + opts->seek;
+  if(sources > 1 || (sources == 0 && opts->stamps.empty())){
+    std::cerr << "Give one of a pattern, a checkpoint to restore or a generation to seek to" << std::endl;
+    return false;
+  }
+
+  if(sources == 0 && (opts->rows == 0 || opts->cols == 0)){
+    std::cerr << "Stamping onto an empty board needs --rows and --cols" << std::endl;
+    return false;
+  }
+
+  if(opts->load_region){
+    std::string ext = opts->pattern_file.substr(opts->pattern_file.find_last_of('.') + 1);
+    if(opts->pattern_file.empty() || ConvertToLowerCase(ext) != "mc" ||
+       opts->rows == 0 || opts->cols == 0){
+      std::cerr << "--region needs a .mc pattern, --rows and --cols" << std::endl;
+      return false;
+    }
+  }
+
+  if(!opts->stamps.empty() && opts->catalog_dir.empty()){
+    std::cerr << "Stamping needs --catalog" << std::endl;
+    return false;
+  }
+
+  // those need the whole board every generation
+  bool whole_board = !opts->stats_file.empty() || !opts->checkpoint_file.empty() ||
+                     (!opts->keyframe_prefix.empty() && !opts->seek) || opts->track_period > 0;
+  if(!opts->symmetry.empty() && whole_board){
+    std::cerr << "--symmetry can't be used with stats, checkpoints, recording keyframes or tracking" << std::endl;
+    return false;
+  }
+
+  if(opts->query_window && (whole_board || !opts->symmetry.empty())){
+    std::cerr << "--window can't be used with stats, checkpoints, recording keyframes, tracking or --symmetry" << std::endl;
+    return false;
+  }
+
+  if(opts->seek && opts->keyframe_prefix.empty()){
+    std::cerr << "Seeking needs --keyframes" << std::endl;
+    return false;
+  }
+
+  if(opts->keyframe_every == 0)
+    opts->keyframe_every = 1;
+
+  if(opts->checkpoint_every == 0)
+    opts->checkpoint_every = 1;
+
+  if(opts->threads == 0)
+    opts->threads = 1;
+
+  return true;
+}
+
+// Stamps the pattern named by a name@row,col spec
+static void applyStamp(PatternCatalog& catalog, std::string spec, LifeBoard& board){
+  size_t at = spec.find_last_of('@');
+  size_t comma = spec.find_last_of(',');
+  char* row_end = nullptr;
+  char* col_end = nullptr;
+  long row = 0, col = 0;
+
+  if(at != std::string::npos && comma != std::string::npos && at < comma){
+    row = strtol(spec.c_str() + at + 1, &row_end, 10);
+    col = strtol(spec.c_str() + comma + 1, &col_end, 10);
+  }
+  if(row_end != spec.c_str() + comma || col_end == nullptr || *col_end != '\0' ||
+     comma == at + 1 || comma + 1 == spec.size())
+    Error("Bad value for --stamp: " + spec);
+
+  std::string name = spec.substr(0, at);
+  if(catalog.stamp(name, board, row, col))
+    return;
+
+  std::vector<std::string> matches = catalog.complete(name, 5);
+  std::string hint;
+  for(size_t i = 0; i < matches.size(); ++i)
+    hint += (i == 0 ? ", did you mean " : " or ") + matches[i];
+  Error("No pattern named " + name + " in the catalog" + hint);
+}
+
+// Steps just the window's light cone and writes the window out
+static int runWindow(const BatchOptions& opts, const LifeBoard& board, WorkerPool* pool){
+  LifeBoard window;
+  ConeStats cone_stats;
+  Timer run_timer;
+
+  run_timer.Start();
+  stepWindow(board, opts.window, opts.gens, window, pool, &cone_stats);
+  double elapsed = run_timer.GetDuration();
+
+  if(!opts.out_file.empty())
+    writePattern(opts.out_file, window);
+
+  std::cout << "board:        " << board.getRows() << "x" << board.getCols() << "\n"
+            << "window:       " << window.getRows() << "x" << window.getCols() << " at "
+            << opts.window.top << "," << opts.window.left << "\n"
+            << "threads:      " << pool->getNumThreads() << "\n"
+            << "generations:  " << window.getGeneration() << "\n"
+            << "population:   " << window.population() << " in the window\n"
+            << "elapsed:      " << elapsed << " s\n"
+            << "stepped:      " << cone_stats.cells_stepped << " cells of "
+            << cone_stats.board_cells << " for the whole board";
+  if(cone_stats.board_cells > 0){
+    std::cout << ", " << 100.0 * (cone_stats.board_cells - cone_stats.cells_stepped) /
+                         cone_stats.board_cells << "% saved";
+  }
+  std::cout << "\n";
+
+  return 0;
+}
+
+int runBatch(int argc, char* argv[]){
+  BatchOptions opts;
+
+  if(!parseOptions(argc, argv, &opts)){
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  LifeBoard board(opts.rows, opts.cols, opts.bound_scheme);
+  WorkerPool pool(opts.threads);
+  KeyframeIndex keyframes(opts.keyframe_prefix);
+  // a seek reads the index, it never writes to it
+  bool recording = !opts.keyframe_prefix.empty() && !opts.seek;
+  unsigned restored = 0;
+  unsigned long long seek_from = 0;
+  double seek_elapsed = 0;
+  double stamp_elapsed = 0;
+
+  if(opts.seek){
+    if(!keyframes.load())
+      Error("Couldn't open keyframe index " + opts.keyframe_prefix + ".index");
+    if(!keyframes.nearestKeyframe(opts.seek_gen, &seek_from))
+      Error("No keyframe at or before the seek generation");
+
+    Timer seek_timer;
+    seek_timer.Start();
+    keyframes.seek(opts.seek_gen, board, &pool);
+    seek_elapsed = seek_timer.GetDuration();
+  }
+  else if(!opts.restore_file.empty())
+    restored = restoreCheckpoint(opts.restore_file, board);
+  else if(opts.load_region){
+    // the tree is kept whole, just the window is flattened
+    MacrocellPattern pattern(opts.pattern_file);
+    pattern.stamp(board, -(long long)opts.region_top, -(long long)opts.region_left);
+    board.setGeneration(pattern.getGeneration());
+  }
+  else if(!opts.pattern_file.empty())
+    readPattern(opts.pattern_file, board);
+
+  if(!opts.stamps.empty()){
+    PatternCatalog catalog(opts.catalog_dir);
+    Timer stamp_timer;
+    stamp_timer.Start();
+    for(size_t i = 0; i < opts.stamps.size(); ++i)
+      applyStamp(catalog, opts.stamps[i], board);
+    stamp_elapsed = stamp_timer.GetDuration();
+  }
+
+  if(opts.query_window)
+    return runWindow(opts, board, &pool);
+
+  if(recording){
+    keyframes.clear();
+    keyframes.add(board);
+  }
+
+  Checkpointer checkpointer(opts.checkpoint_file, opts.checkpoint_budget);
+  bool checkpointing = !opts.checkpoint_file.empty();
+  Timer run_timer;
+
+  std::unique_ptr<ObjectTracker> tracker;
+  if(opts.track_period > 0)
+    tracker.reset(new ObjectTracker(opts.track_period));
+
+  std::unique_ptr<StatsStream> stats_stream;
+  StepStats step_stats;
+  if(!opts.stats_file.empty()){
+    stats_stream.reset(new StatsStream(opts.stats_file, opts.stats_binary ? sfBinary : sfCSV,
+                                       tracker != nullptr));
+  }
+
+  // the symmetric board takes over the stepping and the board gets
+  // its result back at the end
+  std::unique_ptr<SymmetricBoard> symmetric;
+  Symmetry symmetry = symNone;
+  if(!opts.symmetry.empty()){
+    // a donut's symmetry doesn't split it, so auto leaves it whole
+    if(opts.symmetry == "auto")
+      symmetry = (board.getBoundScheme() == Donut) ? symNone : detectSymmetry(board);
+    else
+      symmetry = (opts.symmetry == "lr") ? symLeftRight : (opts.symmetry == "tb") ? symTopBottom : symD4;
+    if(symmetry != symNone)
+      symmetric.reset(new SymmetricBoard(board, symmetry));
+  }
+
+  run_timer.Start();
+  if(checkpointing)
+    checkpointer.start(board);
+
+  for(unsigned long long gen = 1; gen <= opts.gens; ++gen){
+    if(symmetric)
+      symmetric->step(&pool);
+    else if(stats_stream)
+      board.step(&pool, &step_stats);
+    else
+      board.step(&pool);
+
+    if(tracker)
+      tracker->update(board, &pool);
+    if(stats_stream)
+      stats_stream->write(board.getGeneration(), step_stats, tracker ? &tracker->getCounts() : nullptr);
+
+    if(recording && board.getGeneration() % opts.keyframe_every == 0)
+      keyframes.add(board);
+    if(checkpointing && gen % opts.checkpoint_every == 0)
+      checkpointer.checkpoint(board, gen == opts.gens);
+  }
+
+  if(symmetric)
+    symmetric->reconstruct(board);
+
+  // the last generation is always saved
+  if(checkpointing && opts.gens % opts.checkpoint_every != 0)
+    checkpointer.checkpoint(board, true);
+  double elapsed = run_timer.GetDuration();
+
+  // flushes whatever the writer hasn't caught up with
+  stats_stream.reset();
+
+  if(!opts.out_file.empty())
+    writePattern(opts.out_file, board);
+
+  ComponentLabeler labeler;
+  double label_elapsed = 0;
+  if(opts.label_objects){
+    Timer label_timer;
+    label_timer.Start();
+    labeler.label(board, &pool);
+    label_elapsed = label_timer.GetDuration();
+  }
+
+  double cells = (double)board.getRows() * board.getCols() * opts.gens;
+
+  std::cout << "board:        " << board.getRows() << "x" << board.getCols() << "\n"
+            << "threads:      " << pool.getNumThreads() << "\n"
+            << "generations:  " << board.getGeneration() << "\n"
+            << "population:   " << board.population() << "\n"
+            << "elapsed:      " << elapsed << " s\n";
+
+  if(!opts.restore_file.empty())
+    std::cout << "restored:     " << restored << " deltas\n";
+
+  if(opts.seek){
+    std::cout << "seek:         " << seek_elapsed << " s from the keyframe at generation "
+              << seek_from << " (" << opts.seek_gen - seek_from << " generations stepped)\n";
+  }
+
+  if(!opts.stamps.empty()){
+    std::cout << "stamped:      " << opts.stamps.size() << " patterns in "
+              << stamp_elapsed << " s\n";
+  }
+
+  if(opts.label_objects){
+    std::cout << "objects:      " << labeler.getNumObjects() << " labeled in "
+              << label_elapsed << " s\n";
+
+    std::vector<unsigned> largest(labeler.getNumObjects());
+    for(unsigned k = 0; k < largest.size(); ++k)
+      largest[k] = k;
+    unsigned listed = std::min<unsigned long long>(opts.objects_listed, largest.size());
+    std::partial_sort(largest.begin(), largest.begin() + listed, largest.end(),
+                      [&](unsigned a, unsigned b){
+                        unsigned long long pop_a = labeler.getObject(a).population;
+                        unsigned long long pop_b = labeler.getObject(b).population;
+                        return pop_a != pop_b ? pop_a > pop_b : a < b;
+                      });
+
+    for(unsigned k = 0; k < listed; ++k){
+      const BoardObject& object = labeler.getObject(largest[k]);
+      std::cout << "  " << object.population << " cells in rows " << object.top << "-"
+                << object.bottom << ", cols " << object.left << "-" << object.right << "\n";
+    }
+  }
+
+  if(!opts.symmetry.empty()){
+    if(symmetric){
+      std::cout << "symmetry:     " << symmetryName(symmetric->getSymmetry()) << ", stepped "
+                << symmetric->getWorkFraction() * 100 << "% of the board\n";
+    }
+    else
+      std::cout << "symmetry:     none, stepped the whole board\n";
+  }
+
+  if(tracker){
+    const ObjectCounts& counts = tracker->getCounts();
+    std::cout << "tracked:      " << counts.still << " still, " << counts.oscillators
+              << " oscillating, " << counts.spaceships << " moving, "
+              << counts.unknown << " unknown\n";
+  }
+
+  if(recording)
+    std::cout << "keyframes:    " << keyframes.getNumKeyframes() << "\n";
+
+  if(checkpointing){
+    std::cout << "checkpoints:  " << checkpointer.getDeltasWritten() << " written, "
+              << checkpointer.getDeltasSkipped() << " skipped\n"
+              << "written:      " << checkpointer.getBytesWritten() << " bytes\n";
+  }
+
+  if(elapsed > 0){
+    std::cout << "gens/sec:     " << opts.gens / elapsed << "\n"
+              << "cells/sec:    " << cells / elapsed << "\n";
+  }
+
+  return 0;
+}
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef _BATCH_RUN_H
+#define _BATCH_RUN_H
+
+#include <string>
+#include <vector>
+#include "LifeBoard.h"
+#include "LightCone.h"
+
+struct BatchOptions {
+  std::string pattern_file;
+  bool load_region;
+  unsigned long long region_top;      // of the .mc pattern's window loaded
+  unsigned long long region_left;     // if load_region, the board is its size
+  std::string out_file;
+  std::string restore_file;
+  std::string stats_file;
+  std::string catalog_dir;
+  std::vector<std::string> stamps;   // name@row,col
+  bool stats_binary;
+  std::string checkpoint_file;
+  unsigned long long checkpoint_every;
+  double checkpoint_budget;   // bytes per second, 0 for no limit
+  std::string keyframe_prefix;
+  unsigned long long keyframe_every;
+  unsigned long long seek_gen;
+  bool seek;
+  bool label_objects;
+  unsigned long long objects_listed;   // largest objects to print
+  unsigned track_period;              // longest period tracked, 0 for none
+  std::string symmetry;               // auto, lr, tb or d4, empty for none
+  bool query_window;
+  ConeWindow window;                  // the only part stepped if query_window
+  unsigned long long gens;
+  unsigned threads;
+  unsigned rows;
+  unsigned cols;
+  BoundaryScheme bound_scheme;
+};
+
+// Headless mode: loads a pattern, steps it with no window open and
+// writes the result along with run statistics. Returns the exit code.
+int runBatch(int argc, char* argv[]);
+
+// Value of a non-negative count option, calls Error if it isn't one
+unsigned long long parseCount(std::string opt, std::string val);
+
+#endif
@@ -0,0 +1,211 @@
+/*
+ *  Author: Abraham Cardenas / https://github.com/Abe-Crdns
+ */
+
+#ifndef _CHECKPOINT_CPP
+#define _CHECKPOINT_CPP
+
+#include <cstring>
+#include "../lpc_lib/lpclib.h"
+#include "Checkpoint.h"
+#include "Snapshot.h"
+
+static std::string deltaFileFor(std::string base_file){
+  return base_file + ".deltas";
+}
+
+Checkpointer::Checkpointer(std::string _base_file, double bytes_per_sec){
+  base_file = _base_file;
+  budget = bytes_per_sec;
+  bytes_written = 0;
+  deltas_written = 0;
+  deltas_skipped = 0;
+}
+
+void Checkpointer::start(const LifeBoard& board){
+  // the old deltas go before the new base replaces the old one, so a
+  // crash in between never replays them onto the wrong base. The base
+  // is renamed into place, --restore and --checkpoint can share a file.
+  if(delta_out.is_open())
+    delta_out.close();
+  delta_out.open(deltaFileFor(base_file).c_str(), std::ios::out|std::ios::binary|std::ios::trunc);
+  if(delta_out.fail())
+    Error("Couldn't open checkpoint file " + deltaFileFor(base_file));
+
+  writeSnapshot(base_file, board);
+  shadow = board;
+
+  run_timer.Start();
+  bytes_written = sizeof(SnapshotHeader) +
+                  sizeof(uint64_t) * board.getRows() * board.getRowWords();
+}
+
+// XORs the tile against the shadow board, appends it to the payload
+// if anything changed and brings the shadow up to date. Returns the
+// number of words appended.
+unsigned Checkpointer::encodeTile(const LifeBoard& board, unsigned band, unsigned line){
+  uint64_t diff[TILE_ROWS * TILE_WORDS];
+  unsigned first_row = band * TILE_ROWS;
+  unsigned num_rows = board.getRows() - first_row < TILE_ROWS ? board.getRows() - first_row : TILE_ROWS;
+  unsigned num_words = num_rows * TILE_WORDS;
+  bool changed = false;
+
+  for(unsigned r = 0; r < num_rows; ++r){
+    const uint64_t* src = board.getRow(first_row + r) + (line * TILE_WORDS);
+    const uint64_t* old = shadow.getRow(first_row + r) + (line * TILE_WORDS);
+    for(unsigned k = 0; k < TILE_WORDS; ++k){
+      diff[(r * TILE_WORDS) + k] = src[k] ^ old[k];
+      changed |= diff[(r * TILE_WORDS) + k] != 0;
+    }
+  }
+
+  if(!changed)
+    return 0;
+
+  size_t start = payload.size();
+  payload.push_back(((uint64_t)band << 32) | line);
+
+  unsigned i = 0;
+  while(i < num_words){
+    unsigned zeros = 0, literals = 0;
+    while(i + zeros < num_words && diff[i + zeros] == 0)
+      ++zeros;
+    while(i + zeros + literals < num_words && diff[i + zeros + literals] != 0)
+      ++literals;
+
+    payload.push_back(((uint64_t)literals << 16) | zeros);
+    payload.insert(payload.end(), diff + i + zeros, diff + i + zeros + literals);
+    i += zeros + literals;
+  }
+
+  for(unsigned r = 0; r < num_rows; ++r)
+    memcpy(shadow.getRow(first_row + r) + (line * TILE_WORDS),
+           board.getRow(first_row + r) + (line * TILE_WORDS), sizeof(uint64_t) * TILE_WORDS);
+
+  return payload.size() - start;
+}
+
+bool Checkpointer::checkpoint(const LifeBoard& board, bool force){
+  if(!delta_out.is_open() || board.getRows() != shadow.getRows() ||
+     board.getCols() != shadow.getCols()){
+    start(board);
+    return true;
+  }
+
+  if(!force && budget > 0 && bytes_written > budget * run_timer.GetDuration()){
+    ++deltas_skipped;
+    return false;
+  }
+
+  DeltaHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, DELTA_MAGIC, sizeof(header.magic));
+  header.generation = board.getGeneration();
+
+  payload.clear();
+  unsigned num_bands = (board.getRows() + TILE_ROWS - 1) / TILE_ROWS;
+  unsigned num_lines = board.getRowWords() / TILE_WORDS;
+
+  for(unsigned band = 0; band < num_bands; ++band){
+    for(unsigned line = 0; line < num_lines; ++line){
+      if(encodeTile(board, band, line) > 0)
+        ++header.num_tiles;
+    }
+  }
+  header.payload_words = payload.size();
+
+  // the record is only complete once all of it is out, a restore
+  // stops at a partial one
+  delta_out.write((const char*)&header, sizeof(header));
+  delta_out.write((const char*)payload.data(), sizeof(uint64_t) * payload.size());
+  delta_out.flush();
+  if(delta_out.fail())
+    Error("Couldn't write checkpoint file " + deltaFileFor(base_file));
+
+  bytes_written += sizeof(header) + (sizeof(uint64_t) * payload.size());
+  ++deltas_written;
+  return true;
+}
+
+unsigned long long Checkpointer::getBytesWritten() const{
+  return bytes_written;
+}
+
+unsigned Checkpointer::getDeltasWritten() const{
+  return deltas_written;
+}
+
+unsigned Checkpointer::getDeltasSkipped() const{
+  return deltas_skipped;
+}
+
+// XORs one record's tiles into the board, false if it's malformed
+static bool applyDelta(const std::vector<uint64_t>& payload, unsigned num_tiles,
+                       LifeBoard& board){
+  size_t pos = 0;
+  unsigned num_lines = board.getRowWords() / TILE_WORDS;
+
+  for(unsigned t = 0; t < num_tiles; ++t){
+    if(pos >= payload.size())
+      return false;
+
+    unsigned band = payload[pos] >> 32;
+    unsigned line = payload[pos] & 0xFFFFFFFF;
+    ++pos;
+    if((unsigned long long)band * TILE_ROWS >= board.getRows() || line >= num_lines)
+      return false;
+
+    unsigned first_row = band * TILE_ROWS;
+    unsigned num_rows = board.getRows() - first_row < TILE_ROWS ? board.getRows() - first_row : TILE_ROWS;
+    unsigned num_words = num_rows * TILE_WORDS;
+
+    unsigned i = 0;
+    while(i < num_words){
+      if(pos >= payload.size())
+        return false;
+
+      unsigned zeros = payload[pos] & 0xFFFF;
+      unsigned literals = (payload[pos] >> 16) & 0xFFFF;
+      ++pos;
+      if(i + zeros + literals > num_words || pos + literals > payload.size())
+        return false;
+
+      i += zeros;
+      for(unsigned k = 0; k < literals; ++k, ++i)
+        board.getRow(first_row + (i / TILE_WORDS))[(line * TILE_WORDS) + (i % TILE_WORDS)] ^= payload[pos++];
+    }
+  }
+
+  return pos == payload.size();
+}
+
+unsigned restoreCheckpoint(std::string base_file, LifeBoard& board){
+  readSnapshot(base_file, board);
+
+  std::ifstream infile(deltaFileFor(base_file).c_str(), std::ios::in|std::ios::binary);
+  if(infile.fail())
+    return 0;
+
+  DeltaHeader header;
+  std::vector<uint64_t> payload;
+  unsigned applied = 0;
+
+  while(infile.read((char*)&header, sizeof(header))){
+    if(memcmp(header.magic, DELTA_MAGIC, sizeof(header.magic)) != 0)
+      Error("Improperly formed checkpoint file " + deltaFileFor(base_file));
+
+    payload.resize(header.payload_words);
+    if(!infile.read((char*)payload.data(), sizeof(uint64_t) * payload.size()))
+      break;
+
+    if(!applyDelta(payload, header.num_tiles, board))
+      Error("Improperly formed checkpoint file " + deltaFileFor(base_file));
+
+    board.setGeneration(header.generation);
+    ++applied;
+  }
+
+  return applied;
+}
+
+#endif
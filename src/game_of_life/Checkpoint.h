@@ -0,0 +1,63 @@
+#ifndef _CHECKPOINT_H
+#define _CHECKPOINT_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "LifeBoard.h"
+#include "private/Timer.h"
+
+#define DELTA_MAGIC "GOLDELTA"
+
+// One record of a .deltas file, followed by payload_words words. Each
+// changed tile is a (band << 32 | line) word and then its words XOR'd
+// with the previous checkpoint, run-length coded as tokens of
+// (literals << 16 | zeros) followed by the literal words.
+struct DeltaHeader {
+  char magic[8];
+  uint64_t generation;
+  uint32_t num_tiles;
+  uint32_t reserved;
+  uint64_t payload_words;
+};
+
+// Writes a base snapshot and then, at each checkpoint, only the tiles
+// that changed since the last one written. With a budget set, a
+// checkpoint is skipped while the bytes written so far are ahead of
+// budget * elapsed seconds; the next one picks up its changes.
+class Checkpointer {
+  private:
+    std::string base_file;
+    std::ofstream delta_out;
+    LifeBoard shadow;       // the board as of the last checkpoint written
+    double budget;          // bytes per second, 0 for no limit
+    Timer run_timer;
+
+    unsigned long long bytes_written;
+    unsigned deltas_written;
+    unsigned deltas_skipped;
+    std::vector<uint64_t> payload;
+
+    unsigned encodeTile(const LifeBoard& board, unsigned band, unsigned line);
+
+  public:
+    Checkpointer(std::string _base_file, double bytes_per_sec = 0);
+
+    // Writes the base snapshot and starts a new delta file
+    void start(const LifeBoard& board);
+
+    // Appends a delta, returns false if the budget skipped it. A forced
+    // checkpoint is always written.
+    bool checkpoint(const LifeBoard& board, bool force = false);
+
+    unsigned long long getBytesWritten() const;
+    unsigned getDeltasWritten() const;
+    unsigned getDeltasSkipped() const;
+};
+
+// Loads the base snapshot and replays every complete delta after it.
+// Returns the number of deltas applied.
+unsigned restoreCheckpoint(std::string base_file, LifeBoard& board);
+
+#endif
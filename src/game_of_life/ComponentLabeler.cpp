@@ -0,0 +1,218 @@
+/*
+ *  Author: Abraham Cardenas / https://github.com/Abe-Crdns
+ */
+
+#ifndef _COMPONENT_LABELER_CPP
+#define _COMPONENT_LABELER_CPP
+
+#include <algorithm>
+#include "../lpc_lib/lpclib.h"
+#include "ComponentLabeler.h"
+
+// Live cells of the word whose west neighbour is dead, i.e. where a
+// run begins. prev is the word to the west.
+static inline uint64_t runStarts(uint64_t word, uint64_t prev){
+  return word & ~((word << 1) | (prev >> 63));
+}
+
+// Same for where a run ends, next being the word to the east
+static inline uint64_t runEnds(uint64_t word, uint64_t next){
+  return word & ~((word >> 1) | (next << 63));
+}
+
+static uint32_t countRuns(const uint64_t* row, unsigned words){
+  uint32_t count = 0;
+  uint64_t prev = 0;
+  for(unsigned k = 0; k < words; ++k){
+    count += __builtin_popcountll(runStarts(row[k], prev));
+    prev = row[k];
+  }
+  return count;
+}
+
+ComponentLabeler::ComponentLabeler(){
+  rows = 0;
+}
+
+// Path halving. A root is always the smallest run of its set, so
+// every parent comes before its child.
+uint32_t ComponentLabeler::findRoot(uint32_t run){
+  while(run_label[run] != run){
+    run_label[run] = run_label[run_label[run]];
+    run = run_label[run];
+  }
+  return run;
+}
+
+// Joins each run of the row with the runs of the row above it that
+// overlap it or touch it diagonally. The roots of the two runs being
+// compared are kept until one of them moves on, since every join made
+// here goes through them.
+void ComponentLabeler::joinRows(unsigned row){
+  uint32_t a = row_runs[row - 1], a_last = row_runs[row];
+  uint32_t b = row_runs[row], b_last = row_runs[row + 1];
+  uint32_t root_a = NO_OBJECT, root_b = NO_OBJECT;
+
+  while(a < a_last && b < b_last){
+    if(run_start[a] <= run_end[b] + 1 && run_start[b] <= run_end[a] + 1){
+      if(root_a == NO_OBJECT)
+        root_a = findRoot(a);
+      if(root_b == NO_OBJECT)
+        root_b = findRoot(b);
+
+      if(root_a < root_b){
+        run_label[root_b] = root_a;
+        root_b = root_a;
+      }
+      else if(root_b < root_a){
+        run_label[root_a] = root_b;
+        root_a = root_b;
+      }
+    }
+
+    if(run_end[a] < run_end[b]){
+      ++a;
+      root_a = NO_OBJECT;
+    }
+    else{
+      ++b;
+      root_b = NO_OBJECT;
+    }
+  }
+}
+
+void ComponentLabeler::labelBand(const LifeBoard& board, unsigned band){
+  unsigned first_row = band * TILE_ROWS;
+  unsigned last_row = std::min(first_row + TILE_ROWS, rows);
+  unsigned words = board.getUsedWords();
+
+  for(unsigned i = first_row; i < last_row; ++i){
+    const uint64_t* row = board.getRow(i);
+    uint32_t start = row_runs[i], end = row_runs[i];
+    uint64_t prev = 0;
+
+    for(unsigned k = 0; k < words; ++k){
+      uint64_t next = (k + 1 < words) ? row[k + 1] : 0;
+      for(uint64_t bits = runStarts(row[k], prev); bits != 0; bits &= bits - 1)
+        run_start[start++] = (64 * k) + __builtin_ctzll(bits);
+      for(uint64_t bits = runEnds(row[k], next); bits != 0; bits &= bits - 1)
+        run_end[end++] = (64 * k) + __builtin_ctzll(bits);
+      prev = row[k];
+    }
+
+    for(uint32_t r = row_runs[i]; r < row_runs[i + 1]; ++r)
+      run_label[r] = r;
+
+    // the band's first row is joined to the band above afterwards
+    if(i > first_row)
+      joinRows(i);
+  }
+}
+
+unsigned ComponentLabeler::label(const LifeBoard& board, WorkerPool* pool){
+  rows = board.getRows();
+  unsigned num_bands = (rows + TILE_ROWS - 1) / TILE_ROWS;
+  unsigned words = board.getUsedWords();
+  bool parallel = (pool != nullptr && pool->getNumThreads() > 1 && num_bands > 1);
+
+  auto runBands = [&](const std::function<void(unsigned)>& fn){
+    if(parallel)
+      pool->run(num_bands, fn);
+    else{
+      for(unsigned band = 0; band < num_bands; ++band)
+        fn(band);
+    }
+  };
+
+  // every row's runs are counted first so each band knows where its
+  // runs go
+  row_runs.assign(rows + 1, 0);
+  runBands([&](unsigned band){
+    unsigned last_row = std::min((band + 1) * TILE_ROWS, rows);
+    for(unsigned i = band * TILE_ROWS; i < last_row; ++i)
+      row_runs[i + 1] = countRuns(board.getRow(i), words);
+  });
+
+  uint64_t total = 0;
+  for(unsigned i = 0; i < rows; ++i){
+    total += row_runs[i + 1];
+    if(total >= NO_OBJECT)
+      Error("Too many runs of live cells to label");
+    row_runs[i + 1] = total;
+  }
+
+  run_start.resize(total);
+  run_end.resize(total);
+  run_label.resize(total);
+
+  runBands([&](unsigned band){
+    labelBand(board, band);
+  });
+
+  for(unsigned band = 1; band < num_bands; ++band)
+    joinRows(band * TILE_ROWS);
+
+  // a run's parent comes before it and has already been given its
+  // object, so one pass in order numbers every run
+  uint32_t num_objects = 0;
+  for(uint32_t r = 0; r < total; ++r)
+    run_label[r] = (run_label[r] == r) ? num_objects++ : run_label[run_label[r]];
+
+  BoardObject empty;
+  empty.top = empty.left = NO_OBJECT;
+  empty.bottom = empty.right = 0;
+  empty.population = 0;
+  objects.assign(num_objects, empty);
+
+  for(unsigned i = 0; i < rows; ++i){
+    for(uint32_t r = row_runs[i]; r < row_runs[i + 1]; ++r){
+      BoardObject& object = objects[run_label[r]];
+      object.top = std::min(object.top, i);
+      object.bottom = i;
+      object.left = std::min(object.left, run_start[r]);
+      object.right = std::max(object.right, run_end[r]);
+      object.population += run_end[r] - run_start[r] + 1;
+    }
+  }
+
+  return objects.size();
+}
+
+unsigned ComponentLabeler::getNumObjects() const{
+  return objects.size();
+}
+
+const BoardObject& ComponentLabeler::getObject(unsigned object) const{
+  return objects[object];
+}
+
+const std::vector<BoardObject>& ComponentLabeler::getObjects() const{
+  return objects;
+}
+
+unsigned ComponentLabeler::objectAt(unsigned row, unsigned col) const{
+  if(row >= rows)
+    return NO_OBJECT;
+
+  // the last run starting at or before col
+  std::vector<uint32_t>::const_iterator first = run_start.begin() + row_runs[row];
+  std::vector<uint32_t>::const_iterator last = run_start.begin() + row_runs[row + 1];
+  std::vector<uint32_t>::const_iterator it = std::upper_bound(first, last, col);
+  if(it == first)
+    return NO_OBJECT;
+
+  uint32_t run = (it - run_start.begin()) - 1;
+  return (col <= run_end[run]) ? run_label[run] : NO_OBJECT;
+}
+
+uint32_t ComponentLabeler::firstRun(unsigned row) const{
+  return row_runs[row];
+}
+
+void ComponentLabeler::getRun(uint32_t run, unsigned* start, unsigned* end, unsigned* object) const{
+  *start = run_start[run];
+  *end = run_end[run];
+  *object = run_label[run];
+}
+
+#endif
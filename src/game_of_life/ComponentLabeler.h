@@ -0,0 +1,58 @@
+#ifndef _COMPONENT_LABELER_H
+#define _COMPONENT_LABELER_H
+
+#include <cstdint>
+#include <vector>
+#include "LifeBoard.h"
+#include "private/WorkerPool.h"
+
+// Object of a dead cell
+#define NO_OBJECT 0xFFFFFFFFu
+
+// One 8-connected group of live cells
+struct BoardObject {
+  unsigned top, left, bottom, right;    // bounds, inclusive
+  unsigned long long population;
+};
+
+// Splits a board's live cells into 8-connected objects. Each row's
+// live cells are read a word at a time as runs, and runs touching a
+// run in the row above are joined with union-find. Bands of TILE_ROWS
+// rows are labeled in parallel and then joined across the seams
+// between them. Objects are numbered in the order their first cell
+// comes row by row, so the numbering doesn't depend on the threads.
+// Boards aren't wrapped: an object across a donut's edge is two.
+class ComponentLabeler {
+  private:
+    unsigned rows;
+    std::vector<uint32_t> row_runs;     // first run of each row, then the total
+    std::vector<uint32_t> run_start;    // first and last column of each run
+    std::vector<uint32_t> run_end;
+    std::vector<uint32_t> run_label;    // parent run while joining, then object
+    std::vector<BoardObject> objects;
+
+    uint32_t findRoot(uint32_t run);
+    void joinRows(unsigned row);
+    void labelBand(const LifeBoard& board, unsigned band);
+
+  public:
+    ComponentLabeler();
+
+    // Labels the board's live cells, returns the number of objects
+    unsigned label(const LifeBoard& board, WorkerPool* pool = nullptr);
+
+    unsigned getNumObjects() const;
+    const BoardObject& getObject(unsigned object) const;
+    const std::vector<BoardObject>& getObjects() const;
+
+    // Object holding the cell as of the last label, NO_OBJECT if it
+    // was dead
+    unsigned objectAt(unsigned row, unsigned col) const;
+
+    // The runs of live cells of the last label, row by row: the row's
+    // runs are firstRun(row) up to firstRun(row + 1)
+    uint32_t firstRun(unsigned row) const;
+    void getRun(uint32_t run, unsigned* start, unsigned* end, unsigned* object) const;
+};
+
+#endif
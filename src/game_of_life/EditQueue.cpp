@@ -0,0 +1,91 @@
+/*
+ *  Author: Abraham Cardenas / https://github.com/Abe-Crdns
+ */
+
+#ifndef _EDIT_QUEUE_CPP
+#define _EDIT_QUEUE_CPP
+
+#include "EditQueue.h"
+
+EditQueue::EditQueue(){
+  head.store(nullptr);
+}
+
+EditQueue::~EditQueue(){
+  EditNode* node = head.exchange(nullptr);
+  while(node != nullptr){
+    EditNode* next = node->next;
+    delete node;
+    node = next;
+  }
+}
+
+void EditQueue::push(const CellEdit& edit){
+  EditNode* node = new EditNode;
+  node->edit = edit;
+  node->next = head.load(std::memory_order_relaxed);
+
+  // on failure node->next is reloaded with the current head
+  while(!head.compare_exchange_weak(node->next, node,
+                                    std::memory_order_release,
+                                    std::memory_order_relaxed));
+}
+
+bool EditQueue::isEmpty() const{
+  return head.load(std::memory_order_relaxed) == nullptr;
+}
+
+void EditQueue::applyEdit(const CellEdit& edit, LifeBoard& board){
+  if(edit.type == edStamp){
+    if(edit.pattern)
+      board.stamp(*edit.pattern, edit.row, edit.col);
+    return;
+  }
+
+  if(edit.row < 0 || edit.col < 0 ||
+     edit.row >= (int)board.getRows() || edit.col >= (int)board.getCols())
+    return;
+
+  switch(edit.type){
+    case edSet:
+      board.setCell(edit.row, edit.col, true);
+      break;
+    case edClear:
+      board.setCell(edit.row, edit.col, false);
+      break;
+    case edToggle:
+      board.toggleCell(edit.row, edit.col);
+      break;
+    default:
+      break;
+  }
+}
+
+unsigned EditQueue::drain(LifeBoard& board, std::vector<CellEdit>* applied){
+  EditNode* node = head.exchange(nullptr, std::memory_order_acquire);
+
+  // the list is newest first, reverse it to apply in push order
+  EditNode* ordered = nullptr;
+  while(node != nullptr){
+    EditNode* next = node->next;
+    node->next = ordered;
+    ordered = node;
+    node = next;
+  }
+
+  unsigned count = 0;
+  while(ordered != nullptr){
+    applyEdit(ordered->edit, board);
+    if(applied != nullptr)
+      applied->push_back(ordered->edit);
+
+    EditNode* next = ordered->next;
+    delete ordered;
+    ordered = next;
+    ++count;
+  }
+
+  return count;
+}
+
+#endif
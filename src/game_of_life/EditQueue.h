@@ -0,0 +1,49 @@
+#ifndef _EDIT_QUEUE_H
+#define _EDIT_QUEUE_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "LifeBoard.h"
+
+enum EditType{
+  edSet, edClear, edToggle, edStamp
+};
+
+struct CellEdit {
+  EditType type;
+  int row;
+  int col;
+
+  // only for edStamp, OR'd in with its top left corner at (row, col)
+  std::shared_ptr<const LifeBoard> pattern;
+};
+
+// Multi-producer, single-consumer queue of board edits. Any thread can
+// push without blocking; the thread that steps the board drains every
+// pending edit at once between generations with a single atomic swap.
+class EditQueue {
+  private:
+    struct EditNode {
+      CellEdit edit;
+      EditNode* next;
+    };
+
+    std::atomic<EditNode*> head;
+
+    static void applyEdit(const CellEdit& edit, LifeBoard& board);
+
+  public:
+    EditQueue();
+    ~EditQueue();
+
+    void push(const CellEdit& edit);
+    bool isEmpty() const;
+
+    // Applies the pending edits in the order they were pushed and
+    // returns how many there were. The applied edits are copied to
+    // applied if it's given.
+    unsigned drain(LifeBoard& board, std::vector<CellEdit>* applied = nullptr);
+};
+
+#endif
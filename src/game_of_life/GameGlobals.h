@@ -8,8 +8,13 @@ struct Coords {
   double y;
 };
 
+struct CellCoords {
+  int row;
+  int col;
+};
+
 // Defined in GameOfLife.cpp
-extern GraphicsWindow GAME_WINDOW;
+extern GraphicsWindow* GAME_WINDOW;
 extern unsigned CELL_SIZE;
 
 extern const Color BLACK;
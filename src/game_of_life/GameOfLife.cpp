@@ -5,12 +5,17 @@
 #ifndef _GAME_OF_LIFE_CPP
 #define _GAME_OF_LIFE_CPP
 
+#include <algorithm>
 #include <iostream>
 #include <cmath>
 #include <new>
 #include <map>
+#include <vector>
+#include <cstdlib>
 #include "GameOfLife.h"
 #include "GameGlobals.h"
+#include "LifeBoard.h"
+#include "PredecessorSearch.h"
 #include "private/Timer.h"
 
 #define WINDOW_HEIGHT   680.0
@@ -19,10 +24,19 @@
 #define BUTTON_Y_OFFSET 5.0
 #define GRID_OFFSET     10.0
 #define CELL_OFFSET     2.0
+#define LABEL_TEXT_SIZE 10
 
+// Dead cells around the board's pattern that a parent has to leave
+// dead, how long to look for one before giving up, and how often the
+// loop checks on a search in the background
+#define PARENT_MARGIN    2
+#define PARENT_MAX_NODES 200000000ULL
+#define PARENT_POLL_SECS 0.05
 
-// Define program's global variables
-GraphicsWindow GAME_WINDOW(WINDOW_WIDTH, WINDOW_HEIGHT, "The Game of Life");
+
+// Define program's global variables, the window is only
+// opened once a GameOfLife is constructed
+GraphicsWindow* GAME_WINDOW = nullptr;
 unsigned CELL_SIZE = 10;
 
 const Color BLACK(0, 0, 0);
@@ -32,21 +46,21 @@ const Color DARK_GREY(50, 50, 50);
 
 // Button types
 enum ButtonValue{
-  evGrid, evClear, evStep, 
-  evRun, evExit
-};
-
-enum BoundaryScheme{
-  Flat, Donut, Mirror
+  evGrid, evClear, evBack,
+  evStep, evRun, evTags, evParent,
+  evExit
 };
 
 static const std::map<std::string, ButtonValue> init_map(){
   std::map<std::string, ButtonValue> m;
   m["00_Grid"] = evGrid;
   m["01_Clear"] = evClear;
-  m["02_Step"] = evStep;
-  m["03_Run"] = evRun;
-  m["04_Exit"] = evExit;
+  m["02_Back"] = evBack;
+  m["03_Step"] = evStep;
+  m["04_Run"] = evRun;
+  m["05_Tags"] = evTags;
+  m["06_Parent"] = evParent;
+  m["07_Exit"] = evExit;
   return m;
 }
 
@@ -82,9 +96,9 @@ static double GRID_HEIGHT = GRID_MAX_HEIGHT - GRID_ROWS_MARGIN;
 static double GRID_WIDTH = GRID_MAX_WIDTH - GRID_COLS_MARGIN; 
 
 
-GameOfLife::GameOfLife(){
+GameOfLife::GameOfLife(size_t history_budget) : history(history_budget){
   try{
-    cells = new Cell*[GRID_ROWS * GRID_COLS];
+    GAME_WINDOW = new GraphicsWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "The Game of Life");
     buttons = new Button*[mapButtonValues.size()];
   }
   catch(std::bad_alloc& ba){
@@ -106,12 +120,13 @@ GameOfLife::GameOfLife(){
     button_x += (BUTTON_WIDTH + BUTTON_X_OFFSET);
   } 
 
-  // draw the grid
-  drawGrid();
-  GAME_WINDOW.Refresh();
+  // initialize the board and draw the grid
+  board.resize(GRID_ROWS, GRID_COLS);
+  board.setBoundScheme(BOUND_SCHEME);
+  history.reset(board);
 
-  // initialize all the cells
-  initCells();
+  drawGrid();
+  GAME_WINDOW->Refresh();
 }
 
 GameOfLife::~GameOfLife(){
@@ -124,120 +139,117 @@ GameOfLife::~GameOfLife(){
     delete[] buttons;
   }
 
-  if(cells != nullptr){
-    for(unsigned i = 0; i < GRID_ROWS; ++i){
-      for(unsigned j = 0; j < GRID_COLS; ++j){
-        if(cells[(i * GRID_COLS) + j] != nullptr)
-          delete cells[(i * GRID_COLS) + j];
-      }
-    }
-    
-    delete[] cells;
-  }
+  delete GAME_WINDOW;
+  GAME_WINDOW = nullptr;
 }
 
 void GameOfLife::drawGrid(bool drawGridLines){
   double grid_x = GRID_OFFSET + (GRID_COLS_MARGIN/2);
   double grid_y = GRID_OFFSET + (GRID_ROWS_MARGIN/2);
 
-  GAME_WINDOW.DrawRectangle(grid_x, grid_y, GRID_WIDTH, 
+  GAME_WINDOW->DrawRectangle(grid_x, grid_y, GRID_WIDTH, 
                             GRID_HEIGHT, DARK_GREY, true);
 
   if(drawGridLines){
     for(unsigned i = 0; i < GRID_ROWS + 1; ++i){
-      GAME_WINDOW.DrawLine(grid_x, grid_y, grid_x + GRID_WIDTH, grid_y, GREY);
+      GAME_WINDOW->DrawLine(grid_x, grid_y, grid_x + GRID_WIDTH, grid_y, GREY);
       grid_y += CELL_SIZE + CELL_OFFSET;
     }
     grid_y = GRID_OFFSET + (GRID_ROWS_MARGIN/2);
     for(unsigned j = 0; j < GRID_COLS + 1; ++j){
-      GAME_WINDOW.DrawLine(grid_x, grid_y, grid_x, grid_y + GRID_HEIGHT, GREY);
+      GAME_WINDOW->DrawLine(grid_x, grid_y, grid_x, grid_y + GRID_HEIGHT, GREY);
       grid_x += CELL_SIZE + CELL_OFFSET;
     }
   }
 }
 
-void GameOfLife::initCells(){
-  double start_pixel = GRID_OFFSET + floor(CELL_OFFSET/2);
+// Pixel positions only exist at render time, cell identity is (row, col)
+void GameOfLife::drawCell(CellCoords cell, bool alive){
   double step = CELL_SIZE + CELL_OFFSET;
-  double cell_x = start_pixel + (GRID_COLS_MARGIN/2);
-  double cell_y = start_pixel + (GRID_ROWS_MARGIN/2); 
-
-  for(unsigned i = 0; i < GRID_ROWS; ++i){
-    for(unsigned j = 0; j < GRID_COLS; ++j){
-      Coords pos = {cell_x, cell_y};
-      cells[(i * GRID_COLS) + j] = new Cell(pos);
-      cell_x += step;
+  double start_pixel = GRID_OFFSET + floor(CELL_OFFSET/2);
+  double cell_x = start_pixel + (GRID_COLS_MARGIN/2) + (cell.col * step);
+  double cell_y = start_pixel + (GRID_ROWS_MARGIN/2) + (cell.row * step);
+
+  GAME_WINDOW->DrawRectangle(
+    cell_x, cell_y, 
+    CELL_SIZE, CELL_SIZE, 
+    alive ? YELLOW : DARK_GREY, true
+  );
+}
+
+void GameOfLife::drawLiveCells(){
+  unsigned words = board.getUsedWords();
+
+  for(unsigned i = 0; i < board.getRows(); ++i){
+    const uint64_t* row = board.getRow(i);
+    for(unsigned k = 0; k < words; ++k){
+      for(uint64_t bits = row[k]; bits != 0; bits &= bits - 1){
+        CellCoords cell = { (int)i, (int)((k * 64) + __builtin_ctzll(bits)) };
+        drawCell(cell, true);
+      }
     }
-    cell_x = start_pixel + (GRID_COLS_MARGIN/2);
-    cell_y += step;
   }
-
-  GAME_WINDOW.Refresh();
 }
 
-Cell* GameOfLife::searchCellHelper(Coords mouse, unsigned l, unsigned r, 
-                                   int* ind, unsigned offset){
-  Cell* _cell = nullptr;
+// Redraws the cells that changed in the last step
+void GameOfLife::drawChangedCells(){
+  unsigned words = board.getUsedWords();
+
+  for(unsigned i = 0; i < board.getRows(); ++i){
+    const uint64_t* row = board.getRow(i);
+    const uint64_t* prev_row = board.getPreviousRow(i);
+    for(unsigned k = 0; k < words; ++k){
+      for(uint64_t bits = row[k] ^ prev_row[k]; bits != 0; bits &= bits - 1){
+        unsigned bit = __builtin_ctzll(bits);
+        CellCoords cell = { (int)i, (int)((k * 64) + bit) };
+        drawCell(cell, (row[k] >> bit) & 1);
+      }
+    }
+  }
+}
 
-  if(ind != nullptr) 
-    *ind = -1;
+// Labels every object the tracker has classified just above it, or
+// just below it on the top row
+void GameOfLife::drawObjectLabels(){
+  double step = CELL_SIZE + CELL_OFFSET;
+  double grid_x = GRID_OFFSET + (GRID_COLS_MARGIN/2);
+  double grid_y = GRID_OFFSET + (GRID_ROWS_MARGIN/2);
+  const std::vector<TrackedObject>& objects = tracker.getObjects();
 
-  while(l <= r){
-    unsigned m = l + (r - l)/2;
-    Coords curr_pos = cells[m * offset]->getPosition();
+  for(size_t k = 0; k < objects.size(); ++k){
+    std::string label = objectLabel(objects[k]);
+    if(label.empty())
+      continue;
 
-    double min_x = curr_pos.x - (CELL_OFFSET/2);
-    double min_y = curr_pos.y - (CELL_OFFSET/2);
-    double max_x = curr_pos.x + CELL_SIZE + (CELL_OFFSET/2);
-    double max_y = curr_pos.y + CELL_SIZE + (CELL_OFFSET/2);
+    const BoardObject& bounds = objects[k].bounds;
+    double x = grid_x + (bounds.left * step);
+    double y = grid_y + (bounds.top * step) - (LABEL_TEXT_SIZE + 2);
+    if(y < grid_y)
+      y = grid_y + ((bounds.bottom + 1) * step);
 
-    if(mouse.x >= min_x && mouse.y >= min_y && 
-       mouse.x <= max_x && mouse.y <= max_y){
-      _cell = cells[m * offset];
-      break;
-    }
-    else if(ind != nullptr && 
-            ((offset == 1 && mouse.x >= min_x && mouse.x <= max_x) || 
-            (offset > 1 && mouse.y >= min_y && mouse.y <= max_y))){
-      *ind = (int)(m * offset);
-      break;
-    }
-    else if((offset == 1 && mouse.x >= max_x) || 
-            (offset > 1 && mouse.y >= max_y))
-      l = m + 1;
-    else
-      r = m - 1;
+    GAME_WINDOW->DrawString(label, x, y, GREY, LABEL_TEXT_SIZE);
   }
-
-  return _cell;
 }
 
-Cell* GameOfLife::searchCell(Coords mouse){
-  Cell* _cell = nullptr;
+// Constant time hit-test against the grid origin. Each cell owns the
+// square from its top left corner up to the next cell, gaps included.
+bool GameOfLife::searchCell(Coords mouse, CellCoords* cell){
+  double grid_x = GRID_OFFSET + (GRID_COLS_MARGIN/2);
+  double grid_y = GRID_OFFSET + (GRID_ROWS_MARGIN/2);
+  double step = CELL_SIZE + CELL_OFFSET;
 
-  if(GRID_ROWS < GRID_COLS){
-    // search the first column for the mouse y value
-    int row_ind;
-    _cell = searchCellHelper(mouse, 0, GRID_ROWS - 1, &row_ind, GRID_COLS);
+  if(mouse.x < grid_x || mouse.y < grid_y)
+    return false;
 
-    // check if a valid row index was returned and 
-    // cell wasn't found, to search the row at row_ind
-    if(_cell == nullptr && row_ind > -1)
-      _cell = searchCellHelper(mouse, row_ind, row_ind + GRID_COLS - 1);
-  }
-  else{
-    // search the first row for the mouse x value
-    int col_ind;
-    _cell = searchCellHelper(mouse, 0, GRID_COLS - 1, &col_ind);
-
-    // check if a valid column index was returned and 
-    // cell wasn't found, to search the column at col_ind
-    if(_cell == nullptr && col_ind > -1)
-      _cell = searchCellHelper(mouse, col_ind, col_ind + GRID_ROWS - 1, 
-                               nullptr, GRID_COLS);
-  }
+  int col = (int)floor((mouse.x - grid_x)/step);
+  int row = (int)floor((mouse.y - grid_y)/step);
+
+  if(row >= (int)GRID_ROWS || col >= (int)GRID_COLS)
+    return false;
 
-  return _cell;
+  cell->row = row;
+  cell->col = col;
+  return true;
 }
 
 Button* GameOfLife::searchButton(Coords mouse){
@@ -268,11 +280,13 @@ Button* GameOfLife::searchButton(Coords mouse){
 void GameOfLife::turnOffButton(Button* btn){
   switch(mapButtonValues.at(btn->getText())){
     case evClear:
+    case evBack:
     case evStep:
+    case evParent:
     case evExit:
       if(btn->getIsClicked()){
         btn->click();
-        GAME_WINDOW.Refresh();
+        GAME_WINDOW->Refresh();
       }
       break;
 
@@ -281,371 +295,459 @@ void GameOfLife::turnOffButton(Button* btn){
   }
 }
 
-// Behavior of all the boundary cells (first and last row/column cells)
-// TODO: switch on BOUND_SCHEME here to change boundary behavior 
-ptr_cell_set_t GameOfLife::boundCellNeighbors(Coords curr_cell_pos, 
-                                              unsigned* live_neighbors){
-  ptr_cell_set_t bound_neighbors;
-
-  Coords first_cell_pos = cells[0]->getPosition();
-  Coords last_cell_pos = cells[(GRID_ROWS * GRID_COLS) - 1]->getPosition();
-
-  unsigned curr_row = (unsigned)floor(curr_cell_pos.y/(CELL_SIZE + CELL_OFFSET)) - 1;
-  unsigned curr_col = (unsigned)floor(curr_cell_pos.x/(CELL_SIZE + CELL_OFFSET)) - 1;
-
-  // top left, top right, bottom left, and bottom right corner cells
-  if((curr_cell_pos.x == first_cell_pos.x && curr_cell_pos.y == first_cell_pos.y) || 
-     (curr_cell_pos.x == last_cell_pos.x && curr_cell_pos.y == first_cell_pos.y) || 
-     (curr_cell_pos.x == first_cell_pos.x && curr_cell_pos.y == last_cell_pos.y) ||
-     (curr_cell_pos.x == last_cell_pos.x && curr_cell_pos.y == last_cell_pos.y)){
-
-    if(curr_cell_pos.x == first_cell_pos.x && curr_cell_pos.y == first_cell_pos.y){
-      if(cells[((curr_row + 1) * GRID_COLS) + (curr_col + 1)]->getIsAlive())
-        live_neighbors++;
-      bound_neighbors.insert(cells[((curr_row + 1) * GRID_COLS) + (curr_col + 1)]);
-    }
-    else if(curr_cell_pos.x == last_cell_pos.x && curr_cell_pos.y == first_cell_pos.y){
-      if(cells[((curr_row + 1) * GRID_COLS) + (curr_col - 1)]->getIsAlive())
-        live_neighbors++;
-      bound_neighbors.insert(cells[((curr_row + 1) * GRID_COLS) + (curr_col - 1)]);
+// Adds the cells on the line between two cells, excluding the first,
+// walking it with Bresenham's algorithm over (row, col)
+void GameOfLife::strokeCells(CellCoords from, CellCoords to, 
+                             std::vector<CellCoords>* edits){
+  int d_col = abs(to.col - from.col), s_col = from.col < to.col ? 1 : -1;
+  int d_row = -abs(to.row - from.row), s_row = from.row < to.row ? 1 : -1;
+  int err = d_col + d_row;
+
+  CellCoords curr = from;
+  while(curr.row != to.row || curr.col != to.col){
+    int err2 = 2 * err;
+    if(err2 >= d_row){
+      err += d_row;
+      curr.col += s_col;
     }
-    else if(curr_cell_pos.x == first_cell_pos.x && curr_cell_pos.y == last_cell_pos.y){
-      if(cells[((curr_row - 1) * GRID_COLS) + (curr_col + 1)]->getIsAlive())
-        live_neighbors++;
-      bound_neighbors.insert(cells[((curr_row - 1) * GRID_COLS) + (curr_col + 1)]);
-    }
-    else{
-      if(cells[((curr_row - 1) * GRID_COLS) + (curr_col - 1)]->getIsAlive())
-        live_neighbors++;
-      bound_neighbors.insert(cells[((curr_row - 1) * GRID_COLS) + (curr_col - 1)]);
-    }
-
-    if((curr_cell_pos.x == first_cell_pos.x && curr_cell_pos.y == first_cell_pos.y) || 
-       (curr_cell_pos.x == first_cell_pos.x && curr_cell_pos.y == last_cell_pos.y)){
-      if(cells[(curr_row * GRID_COLS) + (curr_col + 1)]->getIsAlive())
-        live_neighbors++;
-      bound_neighbors.insert(cells[(curr_row * GRID_COLS) + (curr_col + 1)]);
-    }    
-    else{
-      if(cells[(curr_row * GRID_COLS) + (curr_col - 1)]->getIsAlive())
-        live_neighbors++;
-      bound_neighbors.insert(cells[(curr_row * GRID_COLS) + (curr_col - 1)]);
-    }
-    if((curr_cell_pos.x == first_cell_pos.x && curr_cell_pos.y == first_cell_pos.y) || 
-       (curr_cell_pos.x == last_cell_pos.x && curr_cell_pos.y == first_cell_pos.y)){
-      if(cells[((curr_row + 1) * GRID_COLS) + curr_col]->getIsAlive())
-        live_neighbors++;
-      bound_neighbors.insert(cells[((curr_row + 1) * GRID_COLS) + curr_col]);
-    }
-    else{
-      if(cells[((curr_row - 1) * GRID_COLS) + curr_col]->getIsAlive())
-        live_neighbors++;
-      bound_neighbors.insert(cells[((curr_row - 1) * GRID_COLS) + curr_col]);
+    if(err2 <= d_col){
+      err += d_col;
+      curr.row += s_row;
     }
+    edits->push_back(curr);
   }
-  // first column and last column of cells (excluding corners)
-  else if((curr_cell_pos.x == first_cell_pos.x) || (curr_cell_pos.x == last_cell_pos.x)){
-    for(int i = -1; i < 2; i+=2){
-      if(cells[((curr_row + i) * GRID_COLS) + curr_col]->getIsAlive())
-        live_neighbors++;
-      bound_neighbors.insert(cells[((curr_row + i) * GRID_COLS) + curr_col]);
-    }
+}
 
-    for(int i = -1; i < 2; ++i){
-      if(curr_cell_pos.x == first_cell_pos.x){
-        if(cells[((curr_row + i) * GRID_COLS) + (curr_col + 1)]->getIsAlive())
-          live_neighbors++;
-        bound_neighbors.insert(cells[((curr_row + i) * GRID_COLS) + (curr_col + 1)]);
-      }
-      else{
-        if(cells[((curr_row + i) * GRID_COLS) + (curr_col - 1)]->getIsAlive())
-          live_neighbors++;
-        bound_neighbors.insert(cells[((curr_row + i) * GRID_COLS) + (curr_col - 1)]);
-      }
-    }
+// Queues the stroke, it reaches the board the next time edits are applied
+void GameOfLife::paintCells(std::vector<CellCoords>* edits, bool alive){
+  std::vector<CellCoords>::const_iterator itor;
+  for(itor = edits->begin(); itor != edits->end(); ++itor){
+    CellEdit edit;
+    edit.type = alive ? edSet : edClear;
+    edit.row = itor->row;
+    edit.col = itor->col;
+    edit_queue.push(edit);
   }
-  // first and last rows of cells (excluding corners)
-  else{
-    for(int i = -1; i < 2; i+=2){
-      if(cells[(curr_row * GRID_COLS) + (curr_col + i)]->getIsAlive())
-        live_neighbors++;
-      bound_neighbors.insert(cells[(curr_row * GRID_COLS) + (curr_col + i)]);
-    }
 
-    if(curr_cell_pos.y == first_cell_pos.y){
-      for(int i = -1; i < 2; ++i){
-        if(cells[((curr_row + 1) * GRID_COLS) + (curr_col + i)]->getIsAlive())
-          live_neighbors++;
-        bound_neighbors.insert(cells[((curr_row + 1) * GRID_COLS) + (curr_col + i)]);
-      }
+  edits->clear();
+}
+
+// Drains the edit queue into the board and draws what it touched.
+// Returns false if there was nothing to apply.
+bool GameOfLife::applyEdits(){
+  if(edit_queue.isEmpty())
+    return false;
+
+  std::vector<CellEdit> applied;
+  edit_queue.drain(board, &applied);
+  history.record(board);
+  speculator.cancel();
+  stopParentSearch();
+
+  std::vector<CellEdit>::const_iterator itor;
+  for(itor = applied.begin(); itor != applied.end(); ++itor){
+    int rows = 1, cols = 1;
+    if(itor->type == edStamp && itor->pattern){
+      rows = itor->pattern->getRows();
+      cols = itor->pattern->getCols();
     }
-    else{
-      for(int i = -1; i < 2; ++i){
-        if(cells[((curr_row - 1) * GRID_COLS) + (curr_col + i)]->getIsAlive())
-          live_neighbors++;
-        bound_neighbors.insert(cells[((curr_row - 1) * GRID_COLS) + (curr_col + i)]);
+
+    for(int i = itor->row; i < itor->row + rows; ++i){
+      for(int j = itor->col; j < itor->col + cols; ++j){
+        if(i < 0 || j < 0 || i >= (int)GRID_ROWS || j >= (int)GRID_COLS)
+          continue;
+
+        CellCoords cell = { i, j };
+        drawCell(cell, board.getCell(i, j));
       }
     }
   }
 
-  return bound_neighbors;
+  return true;
 }
 
-ptr_cell_set_t GameOfLife::searchNeighborCells(ptr_cell_set_t __cells, 
-                                               ptr_cell_set_t *cells_searched){
-  ptr_cell_set_t neighbors;
 
-  Coords first_cell_pos = cells[0]->getPosition();
-  Coords last_cell_pos = cells[(GRID_ROWS * GRID_COLS) - 1]->getPosition();
-
-  ptr_cell_set_t::const_iterator itor;
-  for(itor = __cells.begin(); itor != __cells.end(); ++itor){
+// Starts looking for a parent of the board's pattern that stays within
+// PARENT_MARGIN - 1 cells of it and on the board, in the background.
+// Returns false if there's nothing to search.
+bool GameOfLife::startParentSearch(){
+  unsigned top, left, bottom, right;
+  if(!board.boundingBox(&top, &left, &bottom, &right))
+    return false;
+
+  // the target is the pattern with its margin, cut down to the board.
+  // Where it's cut, the parent only has to stay on the board, which
+  // only works out that simply on a flat one.
+  int edges = peConfined;
+  if(top < PARENT_MARGIN || left < PARENT_MARGIN ||
+     bottom + PARENT_MARGIN >= board.getRows() || right + PARENT_MARGIN >= board.getCols()){
+    if(board.getBoundScheme() != Flat){
+      std::cout << "Parent search: the pattern is too close to the edge\n";
+      return false;
+    }
 
-    // check if current cell is not in the cells searched set
-    if(cells_searched->find((*itor)) != cells_searched->end())
-      continue;
+    if(top < PARENT_MARGIN)
+      edges = (edges & ~peTop) | peTopEdge;
+    if(left < PARENT_MARGIN)
+      edges = (edges & ~peLeft) | peLeftEdge;
+    if(bottom + PARENT_MARGIN >= board.getRows())
+      edges = (edges & ~peBottom) | peBottomEdge;
+    if(right + PARENT_MARGIN >= board.getCols())
+      edges = (edges & ~peRight) | peRightEdge;
+  }
 
-    unsigned live_neighbors = 0;
-    Coords curr_cell_pos = (*itor)->getPosition();
-
-    if(curr_cell_pos.x != first_cell_pos.x && curr_cell_pos.x != last_cell_pos.x && 
-       curr_cell_pos.y != first_cell_pos.y && curr_cell_pos.y != last_cell_pos.y){ 
-      unsigned curr_row = (unsigned)floor(curr_cell_pos.y/(CELL_SIZE + CELL_OFFSET)) - 1;
-      unsigned curr_col = (unsigned)floor(curr_cell_pos.x/(CELL_SIZE + CELL_OFFSET)) - 1;
-  
-      // Non-boundary cells (cells with 8 neighbors)
-      for(int i = -1, j = -1; i < 2; ++i, j+=2){    
-        if(cells[((curr_row - 1) * GRID_COLS) + (curr_col + i)]->getIsAlive())
-          live_neighbors++;
-
-        if(cells[((curr_row + 1) * GRID_COLS) + (curr_col + i)]->getIsAlive())
-          live_neighbors++;
-
-        if(j < 2){
-          if(cells[(curr_row * GRID_COLS) + (curr_col + j)]->getIsAlive())
-            live_neighbors++;
-          neighbors.insert(cells[(curr_row * GRID_COLS) + (curr_col + j)]);
-        }
+  top = (top > PARENT_MARGIN) ? top - PARENT_MARGIN : 0;
+  left = (left > PARENT_MARGIN) ? left - PARENT_MARGIN : 0;
+  bottom = std::min(bottom + PARENT_MARGIN, board.getRows() - 1);
+  right = std::min(right + PARENT_MARGIN, board.getCols() - 1);
 
-        neighbors.insert(cells[((curr_row - 1) * GRID_COLS) + (curr_col + i)]);
-        neighbors.insert(cells[((curr_row + 1) * GRID_COLS) + (curr_col + i)]);
-      }
-    }
-    else{
-      ptr_cell_set_t bound_neighbors = boundCellNeighbors(curr_cell_pos, &live_neighbors);
-      neighbors.insert(bound_neighbors.begin(), bound_neighbors.end());
-    }
+  if(right - left + 1 > PARENT_MAX_COLS){
+    std::cout << "Parent search: the pattern is too wide, the most is "
+              << PARENT_MAX_COLS - (2 * PARENT_MARGIN) << " columns\n";
+    return false;
+  }
 
-    // apply the rules of Game of Life
-    if(((*itor)->getIsAlive() && (live_neighbors < 2 || live_neighbors > 3)) || 
-       (!(*itor)->getIsAlive() && live_neighbors == 3))
-      (*itor)->setNeedsUpdate();
+  LifeBoard target(bottom - top + 1, right - left + 1);
+  target.stamp(board, -(int)top, -(int)left);
 
-    // mark the current cell as searched 
-    cells_searched->insert(*itor);
-  }
+  parent_top = (int)top - 1;
+  parent_left = (int)left - 1;
+  parent_finder.start(target, edges, PARENT_MAX_NODES);
+  std::cout << "Parent search: looking, press Parent again to stop\n";
+  return true;
+}
 
-  return neighbors;
+// Reports a finished search and puts the parent on the board if one
+// was found. Returns false if the board is unchanged.
+bool GameOfLife::placeParent(const ParentResult& result){
+  std::cout << "Parent search: " << parentOutcomeName(result.outcome, result.edges) << " after "
+            << result.nodes << " nodes";
+  if(result.elapsed > 0)
+    std::cout << ", " << result.nodes / result.elapsed << " nodes/s";
+  std::cout << "\n";
+
+  if(result.outcome != poFound)
+    return false;
+
+  // whatever's off the board is dead, so clipping it loses nothing
+  board.clear();
+  board.stamp(result.parent, parent_top, parent_left);
+  history.record(board);
+  speculator.cancel();
+  return true;
 }
 
+// The board is changing under a search, so its parent would be wrong
+void GameOfLife::stopParentSearch(){
+  if(!parent_finder.isActive())
+    return;
+
+  parent_finder.cancel();
+  std::cout << "Parent search: stopped\n";
+}
 
 // TODO: Optimize the program while it's running. Currently capped at 20 fps 
 //       since higher fps makes input laggy. Probably b/c Refresh is slow.
 void GameOfLife::run(){
   Timer run_delay;
-  ptr_cell_set_t live_cells;
 
   Button* _button = nullptr;
-  Cell* _cell = nullptr;
+  CellCoords _cell = { -1, -1 };
 
   bool exit_clicked = false;
   bool is_running = false; 
   bool is_step = false;
+  bool is_back = false;
   bool is_grid = false;
+  bool is_tags = false;
+  bool is_parent = false;
+  bool mouse_down = false;
+  bool paint_alive = false;
+  std::vector<CellCoords> cell_edits;
 
   if(GAME_FRAME_RATE > 20)
     std::cout << "Warning: Fps higher than 20 makes the game laggy\n";
 
   // main game loop
   while(!exit_clicked){
-    if(GAME_WINDOW.MouseIsDown()){
-      Coords mouse = { GAME_WINDOW.MouseX(), GAME_WINDOW.MouseY() }; 
-
-      Coords first_btn_pos = buttons[0]->getPosition();
-      Coords last_btn_pos = buttons[mapButtonValues.size()-1]->getPosition();
-      Coords first_cell_pos = cells[0]->getPosition();
-      Coords last_cell_pos = cells[(GRID_ROWS * GRID_COLS)-1]->getPosition();
-
-      // check if a button was clicked while mouse is currently down
-      if(_button == nullptr && 
-         mouse.x >= first_btn_pos.x &&
-         mouse.y >= first_btn_pos.y && 
-         mouse.x <= last_btn_pos.x + BUTTON_WIDTH ){
+    // sleep until the next input event, or the next frame if running,
+    // waking up now and then to check on a parent search
+    double timeout = -1;
+    if(is_running){
+      timeout = 0;
+      if(run_delay.WasStarted())
+        timeout = (1/GAME_FRAME_RATE) - run_delay.GetDuration();
+      if(timeout < 0)
+        timeout = 0;
+    }
+    if(parent_finder.isActive() && (timeout < 0 || timeout > PARENT_POLL_SECS))
+      timeout = PARENT_POLL_SECS;
+
+    InputEvent event;
+    bool has_event = GAME_WINDOW->WaitForEvent(event, timeout);
+
+    // handle every queued event, then draw the frame once
+    bool needs_refresh = false;
+
+    while(has_event){
+      if(event.type == InputEvent::MouseDown)
+        mouse_down = true;
+
+      if(mouse_down && 
+         (event.type == InputEvent::MouseDown || event.type == InputEvent::MouseMove)){
+        Coords mouse = { (double)event.x, (double)event.y }; 
+
+        Coords first_btn_pos = buttons[0]->getPosition();
+        Coords last_btn_pos = buttons[mapButtonValues.size()-1]->getPosition();
+        CellCoords curr_cell;
+
+        // check if a button was clicked while mouse is currently down
+        if(_button == nullptr && _cell.row < 0 &&
+           mouse.x >= first_btn_pos.x &&
+           mouse.y >= first_btn_pos.y && 
+           mouse.x <= last_btn_pos.x + BUTTON_WIDTH ){
        
-        _button = searchButton(mouse);
+          _button = searchButton(mouse);
 
-        if(_button != nullptr){
+          if(_button != nullptr){
 
-          ButtonValue _btn_val = mapButtonValues.at(_button->getText());
+            ButtonValue _btn_val = mapButtonValues.at(_button->getText());
 
-          if(!is_running || (is_running && _btn_val == evRun))
-            _button->click();
-          else
-            _button = nullptr;
+            if(!is_running || (is_running && _btn_val == evRun))
+              _button->click();
+            else
+              _button = nullptr;
 
-          if(_button != nullptr && _btn_val != evRun)
-            GAME_WINDOW.Refresh();
-        } 
-      }
-      else if(_cell == nullptr && !is_running &&
-              mouse.x >= first_cell_pos.x - CELL_OFFSET && 
-              mouse.y >= first_cell_pos.y - CELL_OFFSET && 
-              mouse.x <= last_cell_pos.x + CELL_SIZE + CELL_OFFSET && 
-              mouse.y <= last_cell_pos.y + CELL_SIZE + CELL_OFFSET){
-
-        _cell = searchCell(mouse);
-
-        if(_cell != nullptr){
-          _cell->aliveOrDead();
-
-          // update live cells
-          if(_cell->getIsAlive())
-            live_cells.insert(_cell);
-          else{
-            ptr_cell_set_t::const_iterator itor = live_cells.find(_cell);
-            if(itor != live_cells.end())
-              live_cells.erase(itor);
+            if(_button != nullptr && _btn_val != evRun)
+              needs_refresh = true;
+          } 
+        }
+        else if(searchCell(mouse, &curr_cell) &&
+                (curr_cell.row != _cell.row || curr_cell.col != _cell.col)){
+
+          // a stroke paints the opposite of the cell it starts on, 
+          // filling in every cell between two mouse samples
+          if(_cell.row < 0){
+            paint_alive = !board.getCell(curr_cell.row, curr_cell.col);
+            cell_edits.push_back(curr_cell);
           }
+          else
+            strokeCells(_cell, curr_cell, &cell_edits);
 
-          GAME_WINDOW.Refresh();
-        }  
+          _cell = curr_cell;
+        }
       }
-    }
-    else if(!GAME_WINDOW.MouseIsDown()){
+      else if(event.type == InputEvent::MouseUp){
+        mouse_down = false;
 
-      // check if a cell was previously pressed
-      if(_cell != nullptr)
-        _cell = nullptr;
+        // check if a stroke was being painted
+        if(_cell.row >= 0){
+          _cell.row = _cell.col = -1;
+          paintCells(&cell_edits, paint_alive);
+        }
 
-      // check if a button was previously pressed
-      else if(_button != nullptr){
-        Coords mouse = { GAME_WINDOW.MouseX(), GAME_WINDOW.MouseY() }; 
+        // check if a button was previously pressed
+        else if(_button != nullptr){
+          Coords mouse = { (double)event.x, (double)event.y }; 
 
-        Coords first_btn_pos = buttons[0]->getPosition();
-        Coords last_btn_pos = buttons[mapButtonValues.size()-1]->getPosition();
+          Coords first_btn_pos = buttons[0]->getPosition();
+          Coords last_btn_pos = buttons[mapButtonValues.size()-1]->getPosition();
 
-        if(mouse.x >= first_btn_pos.x && 
-           mouse.y >= first_btn_pos.y &&
-           mouse.x <= last_btn_pos.x + BUTTON_WIDTH){
+          if(mouse.x >= first_btn_pos.x && 
+             mouse.y >= first_btn_pos.y &&
+             mouse.x <= last_btn_pos.x + BUTTON_WIDTH){
 
-          Button* curr_button = searchButton(mouse);
+            Button* curr_button = searchButton(mouse);
 
-          if(curr_button != nullptr && curr_button->getText() == _button->getText()){
+            if(curr_button != nullptr && curr_button->getText() == _button->getText()){
 
-            turnOffButton(curr_button);
+              turnOffButton(curr_button);
 
-            // execute the button
-            switch(mapButtonValues.at(curr_button->getText())){
-              case evGrid:{
-                is_grid = !is_grid;
+              // execute the button
+              switch(mapButtonValues.at(curr_button->getText())){
+                case evGrid:{
+                  is_grid = !is_grid;
 
-                if(is_grid)
-                  drawGrid(true);
-                else
-                  drawGrid();
+                  if(is_grid)
+                    drawGrid(true);
+                  else
+                    drawGrid();
 
-                ptr_cell_set_t::const_iterator itor;
-                for(itor = live_cells.begin(); itor != live_cells.end(); ++itor){
-                  if((*itor)->getIsAlive()){
-                    (*itor)->aliveOrDead();
-                    (*itor)->aliveOrDead();
-                  }
+                  drawLiveCells();
+                  if(is_tags)
+                    drawObjectLabels();
+
+                  needs_refresh = true;
+                  break;
                 }
 
-                GAME_WINDOW.Refresh();
-                break;
-              }
+                case evTags:{
+                  is_tags = !is_tags;
 
-              case evClear:{
-                ptr_cell_set_t::const_iterator itor;
-                for(itor = live_cells.begin(); itor != live_cells.end(); ++itor)
-                  (*itor)->aliveOrDead();
-                
-                live_cells.clear();
+                  // labels start from scratch each time they're shown
+                  tracker.reset();
+                  if(is_tags)
+                    tracker.update(board);
 
-                GAME_WINDOW.Refresh();
-                break;
-              }
+                  drawGrid(is_grid);
+                  drawLiveCells();
+                  if(is_tags)
+                    drawObjectLabels();
 
-              case evStep:
-                is_step = true;
-                break;
+                  needs_refresh = true;
+                  break;
+                }
 
-              case evRun: 
-                is_running = !is_running;
+                case evClear:{
+                  board.clear();
+                  history.reset(board);
+                  speculator.cancel();
+                  stopParentSearch();
+                  tracker.reset();
+                  drawGrid(is_grid);
 
-                for(unsigned i = 0; i < mapButtonValues.size(); ++i){
-                  ButtonValue _btn_val = mapButtonValues.at(buttons[i]->getText());
-                  if(_btn_val != evRun){
-                    if(is_running)
-                      buttons[i]->disable();
-                    else
-                      buttons[i]->enable();
-                  }
+                  needs_refresh = true;
+                  break;
                 }
 
-                if(!is_running){
-                  GAME_WINDOW.Refresh();
-                  run_delay.Reset();
-                }
-                break;
+                case evBack:
+                  is_back = true;
+                  break;
+
+                case evStep:
+                  is_step = true;
+                  break;
+
+                case evParent:
+                  is_parent = true;
+                  break;
+
+                case evRun: 
+                  is_running = !is_running;
+
+                  for(unsigned i = 0; i < mapButtonValues.size(); ++i){
+                    ButtonValue _btn_val = mapButtonValues.at(buttons[i]->getText());
+                    if(_btn_val != evRun){
+                      if(is_running)
+                        buttons[i]->disable();
+                      else
+                        buttons[i]->enable();
+                    }
+                  }
 
-              case evExit:
-                exit_clicked = true;
-                break;
+                  if(!is_running){
+                    needs_refresh = true;
+                    run_delay.Reset();
+                  }
+                  break;
+
+                case evExit:
+                  exit_clicked = true;
+                  break;
 
-              default:
-                break;
+                default:
+                  break;
+              }
             }
+            else
+              turnOffButton(_button);
           }
           else
             turnOffButton(_button);
+
+          _button = nullptr;
         }
-        else
-          turnOffButton(_button);
+      }
+
+      has_event = GAME_WINDOW->PollEvent(event);
+    }
+
+    if(!cell_edits.empty())
+      paintCells(&cell_edits, paint_alive);
+
+    // while running, edits wait for the next generation. Edited
+    // objects start over, so their old labels go.
+    if(!is_running && applyEdits()){
+      if(is_tags){
+        tracker.reset();
+        tracker.update(board);
+        drawGrid(is_grid);
+        drawLiveCells();
+        drawObjectLabels();
+      }
+      needs_refresh = true;
+    }
 
-        _button = nullptr;
+    if(needs_refresh)
+      GAME_WINDOW->Refresh();
+
+    // undo the last generation from the history, pending edits
+    // were applied and recorded above
+    if(is_back){
+      if(history.stepBack(board)){
+        speculator.cancel();
+        stopParentSearch();
+        tracker.reset();
+        if(is_tags)
+          tracker.update(board);
+
+        drawGrid(is_grid);
+        drawLiveCells();
+        if(is_tags)
+          drawObjectLabels();
+        GAME_WINDOW->Refresh();
+      }
+      is_back = false;
+    }
+
+    // look for a board that steps into this one, pending edits were
+    // applied above. Pressing Parent during a search stops it.
+    if(is_parent){
+      if(parent_finder.isActive())
+        stopParentSearch();
+      else
+        startParentSearch();
+      is_parent = false;
+    }
+
+    // replace the board with the parent once the search is done
+    ParentResult parent_result;
+    if(parent_finder.take(parent_result)){
+      if(placeParent(parent_result)){
+        tracker.reset();
+        if(is_tags)
+          tracker.update(board);
+
+        drawGrid(is_grid);
+        drawLiveCells();
+        if(is_tags)
+          drawObjectLabels();
+        GAME_WINDOW->Refresh();
       }
     }
 
     // run or step the game 
     if((is_running && (run_delay.GetDuration() >= (1/GAME_FRAME_RATE) || 
         !run_delay.WasStarted())) || is_step){   
-      ptr_cell_set_t neighbors, cells_searched;
-
-      // search the neighbors of all the live cells and
-      // the neighbors of the neighbors of all the live cells
-      neighbors = searchNeighborCells(live_cells, &cells_searched);
-      searchNeighborCells(neighbors, &cells_searched);
-
-      // update the searched cells that need to be updated 
-      ptr_cell_set_t::const_iterator itor;
-      for(itor = cells_searched.begin(); itor != cells_searched.end(); ++itor){
-        if((*itor)->getNeedsUpdate()){
-          // change the life status of the current cell
-          // and undo needs update 
-          (*itor)->aliveOrDead();
-          (*itor)->setNeedsUpdate();
-
-          // update live cells set
-          if((*itor)->getIsAlive())
-            live_cells.insert(*itor);
-          else if(live_cells.find(*itor) != live_cells.end())
-            live_cells.erase(*itor);
-        }
+      // apply edits made while running between generations, then
+      // take the next generation if it's been worked out already
+      applyEdits();
+      stopParentSearch();
+      if(!speculator.take(board))
+        board.step();
+      history.record(board);
+
+      // labels move with their objects, so the whole board is redrawn
+      if(is_tags){
+        tracker.update(board);
+        drawGrid(is_grid);
+        drawLiveCells();
+        drawObjectLabels();
       }
+      else
+        drawChangedCells();
 
-      GAME_WINDOW.Refresh();
+      GAME_WINDOW->Refresh();
       is_step = false;
 
       // reset the timer and start it again
@@ -654,6 +756,11 @@ void GameOfLife::run(){
         run_delay.Start();
       }
     }
+
+    // idle cores work out the next generations of the board as it
+    // stands, until something other than a step changes it
+    if(!speculator.isActive())
+      speculator.start(board);
   }
 }
 
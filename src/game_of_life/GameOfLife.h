@@ -1,32 +1,48 @@
 #ifndef _GAME_OF_LIFE_H
 #define _GAME_OF_LIFE_H
 
-#include <unordered_set>
+#include <vector>
 #include "../lpc_lib/lpclib.h"
-#include "private/Cell.h"
+#include "GameGlobals.h"
+#include "LifeBoard.h"
+#include "EditQueue.h"
+#include "History.h"
+#include "ObjectTracker.h"
+#include "ParentFinder.h"
+#include "Speculator.h"
 #include "private/Button.h"
 
-typedef std::unordered_set<Cell*, CellHasher> ptr_cell_set_t;
-
 class GameOfLife {
   private: 
-    Cell** cells;
+    LifeBoard board;
+    EditQueue edit_queue;
+    History history;
+    ObjectTracker tracker;
+    Speculator speculator;
+    ParentFinder parent_finder;
+    int parent_top, parent_left;    // board cell of the parent's top left cell
     Button** buttons;
 
     void drawGrid(bool drawGridLines = false);
-    void initCells();
+    void drawCell(CellCoords cell, bool alive);
+    void drawLiveCells();
+    void drawChangedCells();
+    void drawObjectLabels();
     void turnOffButton(Button* btn);
 
-    Cell* searchCellHelper(Coords mouse, unsigned l, unsigned r, 
-                           int* ind = nullptr, unsigned offset = 1);
-    Cell* searchCell(Coords mouse);
+    bool searchCell(Coords mouse, CellCoords* cell);
     Button* searchButton(Coords mouse);
 
-    ptr_cell_set_t searchNeighborCells(ptr_cell_set_t __cells, ptr_cell_set_t *cells_searched);
-    ptr_cell_set_t boundCellNeighbors(Coords curr_cell_pos, unsigned* live_neighbors);
+    void strokeCells(CellCoords from, CellCoords to, std::vector<CellCoords>* edits);
+    void paintCells(std::vector<CellCoords>* edits, bool alive);
+    bool applyEdits();
+    bool startParentSearch();
+    bool placeParent(const ParentResult& result);
+    void stopParentSearch();
 
   public:
-    GameOfLife();
+    // history_budget caps the bytes kept for stepping back
+    GameOfLife(size_t history_budget = DEFAULT_HISTORY_BUDGET);
     ~GameOfLife();
 
     void run();
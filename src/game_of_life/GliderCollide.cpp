@@ -0,0 +1,415 @@
+/*
+ *  Author: Abraham Cardenas / https://github.com/Abe-Crdns
+ */
+
+#ifndef _GLIDER_COLLIDE_CPP
+#define _GLIDER_COLLIDE_CPP
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
+#include "../lpc_lib/lpclib.h"
+#include "BatchRun.h"
+#include "GliderCollide.h"
+#include "ObjectCode.h"
+#include "PatternFile.h"
+#include "SoupCensus.h"
+#include "private/Timer.h"
+#include "private/WorkerPool.h"
+
+// Collisions handed out to a thread at a time
+static const unsigned long long COLLISIONS_PER_CHUNK = 64;
+
+// Times a collision whose debris reaches the edge is run again, on a
+// board twice as wide each time, before it's given up on
+static const unsigned COLLIDE_RETRIES = 2;
+
+static const char* HEADING_NAMES[] = { "SE", "NW", "NE", "SW" };
+
+// The four phases of a glider heading SE, in the same frame: phase 0's
+// 3x3 box starts at (0, 0) and each phase is a generation on
+static const std::vector<CellList>& gliderPhases(){
+  static const std::vector<CellList> phases = [](){
+    LifeBoard board(8, 8);
+    board.setCell(1, 2, true);
+    board.setCell(2, 3, true);
+    board.setCell(3, 1, true);
+    board.setCell(3, 2, true);
+    board.setCell(3, 3, true);
+
+    std::vector<CellList> found;
+    for(unsigned p = 0; p < 4; ++p){
+      CellList cells = boardCells(board);
+      for(size_t i = 0; i < cells.size(); ++i){
+        cells[i].first -= 1;
+        cells[i].second -= 1;
+      }
+      found.push_back(cells);
+      board.step();
+    }
+    return found;
+  }();
+  return phases;
+}
+
+CollisionSpace::CollisionSpace(unsigned _num_gliders, int _max_lane, unsigned _max_delay){
+  if(_num_gliders != 2 && _num_gliders != 3)
+    Error("Collisions are between two or three gliders");
+
+  num_gliders = _num_gliders;
+  max_lane = _max_lane;
+  max_delay = _max_delay;
+}
+
+unsigned long long CollisionSpace::size() const{
+  unsigned long long lanes = (2 * max_lane) + 1;
+  unsigned long long count = 2 * lanes * 8;
+  if(num_gliders == 3)
+    count *= 4 * lanes * (max_delay + 1);
+  return count;
+}
+
+unsigned CollisionSpace::boardSide() const{
+  // the furthest glider back has to start clear of the edge, where
+  // spaceships are taken off as escaping
+  unsigned latest = (num_gliders == 3) ? std::max(max_delay, 7u) : 7;
+  unsigned reach = COLLIDE_DISTANCE + ((latest + 3) / 4) + max_lane + 3;
+  return std::max(2 * (reach + ESCAPE_MARGIN + 2), (unsigned)COLLIDE_MIN_SIDE);
+}
+
+// The index is read as mixed-radix digits, the second glider's first
+std::vector<GliderShot> CollisionSpace::collision(unsigned long long index) const{
+  unsigned long long lanes = (2 * max_lane) + 1;
+  std::vector<GliderShot> shots(num_gliders);
+
+  shots[0].heading = ghSE;
+  shots[0].lane = 0;
+  shots[0].delay = 0;
+
+  shots[1].heading = (index % 2 == 0) ? ghNW : ghNE;
+  index /= 2;
+  shots[1].lane = (int)(index % lanes) - max_lane;
+  index /= lanes;
+  shots[1].delay = index % 8;
+  index /= 8;
+
+  if(num_gliders == 3){
+    shots[2].heading = (GliderHeading)(index % 4);
+    index /= 4;
+    shots[2].lane = (int)(index % lanes) - max_lane;
+    index /= lanes;
+    shots[2].delay = index;
+  }
+
+  return shots;
+}
+
+bool placeCollision(const std::vector<GliderShot>& shots, LifeBoard& board){
+  const std::vector<CellList>& phases = gliderPhases();
+  int middle = board.getRows() / 2;
+  std::vector<CellList> placed(shots.size());
+
+  board.clear();
+  board.setGeneration(0);
+
+  for(size_t g = 0; g < shots.size(); ++g){
+    int aim_row = middle, aim_col = middle + shots[g].lane;
+
+    // a glider delayed d generations is where it was d generations
+    // before the undelayed one, which is q whole periods and r phases
+    int back = -(int)((shots[g].delay + 3) / 4);
+    int phase = (4 * -back) - shots[g].delay;
+    int start = -COLLIDE_DISTANCE - 1 + back;
+
+    const CellList& cells = phases[phase];
+    for(size_t i = 0; i < cells.size(); ++i){
+      // relative to the aim, heading SE, then mirrored into its heading
+      int dr = cells[i].first + start;
+      int dc = cells[i].second + start;
+      if(shots[g].heading == ghNW || shots[g].heading == ghNE)
+        dr = -dr;
+      if(shots[g].heading == ghNW || shots[g].heading == ghSW)
+        dc = -dc;
+      placed[g].push_back(std::make_pair(aim_row + dr, aim_col + dc));
+    }
+  }
+
+  // within two cells a birth could need both
+  for(size_t a = 0; a < placed.size(); ++a){
+    for(size_t b = a + 1; b < placed.size(); ++b){
+      for(size_t i = 0; i < placed[a].size(); ++i){
+        for(size_t k = 0; k < placed[b].size(); ++k){
+          if(abs(placed[a][i].first - placed[b][k].first) <= 2 &&
+             abs(placed[a][i].second - placed[b][k].second) <= 2)
+            return false;
+        }
+      }
+    }
+  }
+
+  for(size_t g = 0; g < placed.size(); ++g){
+    for(size_t i = 0; i < placed[g].size(); ++i)
+      board.setCell(placed[g][i].first, placed[g][i].second, true);
+  }
+  return true;
+}
+
+std::string describeCollision(const std::vector<GliderShot>& shots){
+  std::ostringstream desc;
+  for(size_t g = 0; g < shots.size(); ++g){
+    if(g > 0)
+      desc << ", ";
+    desc << HEADING_NAMES[shots[g].heading] << " " << shots[g].lane << " " << shots[g].delay;
+  }
+  return desc.str();
+}
+
+// The objects a collision left, sorted so equal outcomes always get the
+// same key however they were found
+static std::string outcomeKey(const Census& census){
+  std::vector<std::string> codes;
+  for(Census::const_iterator it = census.begin(); it != census.end(); ++it){
+    std::ostringstream code;
+    code << it->first;
+    if(it->second > 1)
+      code << "*" << it->second;
+    codes.push_back(code.str());
+  }
+  std::sort(codes.begin(), codes.end());
+
+  std::string key;
+  for(size_t i = 0; i < codes.size(); ++i){
+    if(i > 0)
+      key += " ";
+    key += codes[i];
+  }
+  return key.empty() ? "nothing" : key;
+}
+
+// Object codes in the first column of a census CSV
+static std::unordered_set<std::string> readKnown(std::string filename){
+  std::ifstream infile(filename.c_str());
+  if(infile.fail())
+    Error("Couldn't open known objects file " + filename);
+
+  std::unordered_set<std::string> known;
+  std::string line;
+  while(std::getline(infile, line)){
+    std::string code = line.substr(0, line.find(','));
+    if(!code.empty() && code != "object")
+      known.insert(code);
+  }
+  return known;
+}
+
+static void printUsage(const char* prog){
+  std::cerr << "usage: " << prog << " collide [options]\n"
+            << "  --gliders <2|3>              gliders per collision (default 2)\n"
+            << "  --lanes <n>                  lanes either side of head on (default 6)\n"
+            << "  --max-delay <n>              latest the third glider arrives (default 24)\n"
+            << "  --threads <n>                collision threads (default: all cores)\n"
+            << "  --max-gens <n>               give up on a collision after this long (default 2000)\n"
+            << "  --known <file>               census CSV of objects that aren't novel\n"
+            << "  --out <file>                 write every distinct outcome here as CSV\n"
+            << "  --patterns <dir>             write each distinct outcome's collision here as RLE\n";
+}
+
+int runCollide(int argc, char* argv[]){
+  unsigned long long max_gens = 2000;
+  unsigned num_gliders = 2, lanes = 6, max_delay = 24;
+  unsigned threads = std::thread::hardware_concurrency();
+  std::string known_file, out_file, pattern_dir;
+
+  for(int i = 2; i < argc; ++i){
+    std::string opt = argv[i];
+
+    if(i + 1 >= argc){
+      std::cerr << "Missing value for " << opt << std::endl;
+      printUsage(argv[0]);
+      return 1;
+    }
+    std::string val = argv[++i];
+
+    if(opt == "--gliders")
+      num_gliders = parseCount(opt, val);
+    else if(opt == "--lanes")
+      lanes = parseCount(opt, val);
+    else if(opt == "--max-delay")
+      max_delay = parseCount(opt, val);
+    else if(opt == "--threads")
+      threads = parseCount(opt, val);
+    else if(opt == "--max-gens")
+      max_gens = parseCount(opt, val);
+    else if(opt == "--known")
+      known_file = val;
+    else if(opt == "--out")
+      out_file = val;
+    else if(opt == "--patterns")
+      pattern_dir = val;
+    else{
+      std::cerr << "Unknown option " << opt << std::endl;
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  if(threads == 0)
+    threads = 1;
+
+  CollisionSpace space(num_gliders, lanes, max_delay);
+  std::unordered_set<std::string> known;
+  if(!known_file.empty())
+    known = readKnown(known_file);
+
+  // the gliders flying on untouched, and nothing else
+  Census missed;
+  missed["xq4_153"] = num_gliders;
+  std::string missed_key = outcomeKey(missed);
+
+  // each thread keeps the outcomes that aren't misses with their
+  // collision's index, so the report doesn't depend on the scheduling
+  unsigned long long total = space.size();
+  WorkerPool pool(threads);
+  std::vector<std::vector<std::pair<unsigned long long, std::string> > > found(threads);
+  std::vector<Census> objects(threads);
+  std::vector<unsigned long long> unsettled(threads, 0), touching(threads, 0), at_edge(threads, 0);
+  std::atomic<unsigned long long> next_collision(0);
+  Timer run_timer;
+
+  run_timer.Start();
+  pool.run(threads, [&](unsigned t){
+    SoupRunner runner(max_gens, space.boardSide());
+    std::vector<std::unique_ptr<SoupRunner> > wider(COLLIDE_RETRIES);
+    Census census;
+    unsigned long long first;
+    while((first = next_collision.fetch_add(COLLISIONS_PER_CHUNK)) < total){
+      unsigned long long last = std::min(first + COLLISIONS_PER_CHUNK, total);
+      for(unsigned long long index = first; index < last; ++index){
+        census.clear();
+        if(!placeCollision(space.collision(index), runner.getBoard())){
+          ++touching[t];
+          continue;
+        }
+        bool settled = runner.settle(census);
+
+        // debris at the edge may have been cut off by it, so what's
+        // left isn't the collision's outcome until it settles clear of it
+        SoupRunner* used = &runner;
+        for(unsigned r = 0; settled && used->reachedEdge() && r < COLLIDE_RETRIES; ++r){
+          if(!wider[r])
+            wider[r].reset(new SoupRunner(max_gens, space.boardSide() << (r + 1)));
+          used = wider[r].get();
+          census.clear();
+          placeCollision(space.collision(index), used->getBoard());
+          settled = used->settle(census);
+        }
+
+        if(!settled){
+          ++unsettled[t];
+          continue;
+        }
+        if(used->reachedEdge()){
+          ++at_edge[t];
+          continue;
+        }
+
+        std::string key = outcomeKey(census);
+        if(key == missed_key)
+          continue;
+        found[t].push_back(std::make_pair(index, key));
+        for(Census::const_iterator it = census.begin(); it != census.end(); ++it)
+          objects[t][it->first] += it->second;
+      }
+    }
+  });
+  double elapsed = run_timer.GetDuration();
+
+  std::vector<std::pair<unsigned long long, std::string> > results;
+  unsigned long long total_unsettled = 0, total_touching = 0, total_at_edge = 0;
+  for(unsigned t = 0; t < threads; ++t){
+    results.insert(results.end(), found[t].begin(), found[t].end());
+    total_unsettled += unsettled[t];
+    total_touching += touching[t];
+    total_at_edge += at_edge[t];
+  }
+  std::sort(results.begin(), results.end());
+
+  // the first collision with each outcome stands for all of them
+  std::unordered_set<std::string> outcomes;
+  std::unordered_set<std::string> seen_objects = known;
+  std::vector<std::pair<unsigned long long, std::string> > distinct;
+  std::vector<std::string> flags;
+  unsigned long long novel = 0, with_gliders = 0;
+
+  for(size_t i = 0; i < results.size(); ++i){
+    if(!outcomes.insert(results[i].second).second)
+      continue;
+
+    std::string flag;
+    std::istringstream codes(results[i].second);
+    std::string code;
+    while(codes >> code){
+      code = code.substr(0, code.find('*'));
+      if(code == "xq4_153" && flag.find("gliders") == std::string::npos){
+        flag += flag.empty() ? "gliders" : " gliders";
+        ++with_gliders;
+      }
+      else if(code != "xq4_153" && code != "nothing" && seen_objects.insert(code).second){
+        flag += flag.empty() ? "new:" : " new:";
+        flag += code;
+        ++novel;
+      }
+    }
+
+    distinct.push_back(results[i]);
+    flags.push_back(flag);
+  }
+
+  if(!out_file.empty()){
+    std::ofstream outfile(out_file.c_str(), std::ios::out|std::ios::trunc);
+    if(outfile.fail())
+      Error("Couldn't open collision file " + out_file);
+    outfile << "index,gliders,outcome,flags\n";
+    for(size_t i = 0; i < distinct.size(); ++i){
+      outfile << distinct[i].first << ",\"" << describeCollision(space.collision(distinct[i].first))
+              << "\"," << distinct[i].second << "," << flags[i] << "\n";
+    }
+  }
+
+  if(!pattern_dir.empty()){
+    LifeBoard board(space.boardSide(), space.boardSide());
+    for(size_t i = 0; i < distinct.size(); ++i){
+      placeCollision(space.collision(distinct[i].first), board);
+      writePattern(pattern_dir + "/collision_" + std::to_string(distinct[i].first) + ".rle", board);
+    }
+  }
+
+  std::cout << "collisions:   " << total << " of " << num_gliders << " gliders\n"
+            << "threads:      " << pool.getNumThreads() << "\n"
+            << "touching:     " << total_touching << " skipped\n"
+            << "unsettled:    " << total_unsettled << "\n"
+            << "unresolved:   " << total_at_edge << " still reaching the edge of a "
+            << (space.boardSide() << COLLIDE_RETRIES) << " wide board\n"
+            << "outcomes:     " << distinct.size() << " distinct, " << novel << " new objects, "
+            << with_gliders << " with gliders out\n"
+            << "elapsed:      " << elapsed << " s\n";
+
+  if(elapsed > 0){
+    std::cout << "collisions/s: " << total / elapsed << "\n"
+              << "per core:     " << total / elapsed / pool.getNumThreads() << "\n";
+  }
+
+  for(size_t i = 0; i < distinct.size() && i < 10; ++i){
+    std::cout << "  " << describeCollision(space.collision(distinct[i].first)) << "  ->  "
+              << distinct[i].second << "\n";
+  }
+
+  return 0;
+}
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef _GLIDER_COLLIDE_H
+#define _GLIDER_COLLIDE_H
+
+#include <string>
+#include <vector>
+#include "LifeBoard.h"
+
+// Each glider starts COLLIDE_DISTANCE diagonal steps short of the
+// cell it's aimed at, plus a step for every 4 generations it's delayed.
+// Boards are at least COLLIDE_MIN_SIDE across, so debris has room.
+#define COLLIDE_DISTANCE 12
+#define COLLIDE_MIN_SIDE 96
+
+enum GliderHeading{
+  ghSE = 0,
+  ghNW = 1,
+  ghNE = 2,
+  ghSW = 3
+};
+
+// One glider of a collision: where it's going, the column it's aimed
+// at relative to the middle of the board and how many generations
+// after the first glider it gets there
+struct GliderShot{
+  GliderHeading heading;
+  int lane;
+  unsigned delay;
+};
+
+// Every collision of two or three gliders, numbered. The first glider
+// always heads SE in lane 0 and the second heads NW or NE (SW and the
+// rest are mirror images) in any lane up to max_lane either side, with
+// a delay of 0 to 7: together with the lane that covers every relative
+// position and phase. A third glider heads any way, in any lane, with
+// a delay up to max_delay so it can hit what the first two left.
+class CollisionSpace {
+  private:
+    unsigned num_gliders;
+    int max_lane;
+    unsigned max_delay;
+
+  public:
+    CollisionSpace(unsigned _num_gliders, int _max_lane, unsigned _max_delay);
+
+    unsigned long long size() const;
+
+    // Smallest square board every collision starts clear of the edge on
+    unsigned boardSide() const;
+    std::vector<GliderShot> collision(unsigned long long index) const;
+};
+
+// Clears the board and places the gliders, aimed at its middle.
+// Returns false if any two start close enough to touch, which isn't a
+// collision at all.
+bool placeCollision(const std::vector<GliderShot>& shots, LifeBoard& board);
+
+// Such as "SE 0 0, NW -2 5": heading, lane and delay of each glider
+std::string describeCollision(const std::vector<GliderShot>& shots);
+
+// Headless search: "collide" followed by its options runs every
+// collision across the cores and reports the distinct outcomes.
+// Returns the exit code.
+int runCollide(int argc, char* argv[]);
+
+#endif
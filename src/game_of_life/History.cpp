@@ -0,0 +1,155 @@
+/*
+ *  Author: Abraham Cardenas / https://github.com/Abe-Crdns
+ */
+
+#ifndef _HISTORY_CPP
+#define _HISTORY_CPP
+
+#include <cstring>
+#include "History.h"
+
+History::History(size_t _budget, unsigned _keyframe_interval){
+  budget = _budget;
+  keyframe_interval = _keyframe_interval > 0 ? _keyframe_interval : 1;
+  base_generation = 0;
+  last_keyframe = 0;
+  bytes_used = 0;
+}
+
+void History::reset(const LifeBoard& board){
+  shadow = board;
+  entries.clear();
+  base_generation = board.getGeneration();
+  last_keyframe = board.getGeneration();
+  bytes_used = 0;
+}
+
+void History::record(const LifeBoard& board){
+  if(board.getRows() != shadow.getRows() || board.getCols() != shadow.getCols()){
+    reset(board);
+    return;
+  }
+
+  Entry entry;
+  entry.generation = board.getGeneration();
+
+  unsigned words = board.getRowWords();
+  for(unsigned i = 0; i < board.getRows(); ++i){
+    const uint64_t* row = board.getRow(i);
+    uint64_t* old = shadow.getRow(i);
+    for(unsigned k = 0; k < board.getUsedWords(); ++k){
+      uint64_t diff = row[k] ^ old[k];
+      if(diff != 0){
+        entry.index.push_back((i * words) + k);
+        entry.bits.push_back(diff);
+        old[k] = row[k];
+      }
+    }
+  }
+  shadow.setGeneration(board.getGeneration());
+
+  if(entry.index.empty() && entry.generation == generationAfterLast())
+    return;
+
+  if(entry.generation >= last_keyframe + keyframe_interval){
+    entry.keyframe.assign(board.getRow(0), board.getRow(0) + ((size_t)board.getRows() * words));
+    last_keyframe = entry.generation;
+  }
+
+  entry.bytes = sizeof(Entry) + (sizeof(uint32_t) * entry.index.size()) +
+                (sizeof(uint64_t) * (entry.bits.size() + entry.keyframe.size()));
+  bytes_used += entry.bytes;
+  entries.push_back(entry);
+
+  // the oldest changes go first, the board before what's left
+  // becomes the new base
+  while(bytes_used > budget && entries.size() > 1){
+    base_generation = entries.front().generation;
+    bytes_used -= entries.front().bytes;
+    entries.pop_front();
+  }
+}
+
+unsigned long long History::generationAfterLast() const{
+  return entries.empty() ? base_generation : entries.back().generation;
+}
+
+void History::applyEntry(const Entry& entry, LifeBoard& board){
+  uint64_t* words = board.getRow(0);
+  for(size_t i = 0; i < entry.index.size(); ++i)
+    words[entry.index[i]] ^= entry.bits[i];
+}
+
+bool History::stepBack(LifeBoard& board, unsigned long long num_gens){
+  unsigned long long curr_gen = generationAfterLast();
+  if(entries.empty() || base_generation >= curr_gen || num_gens == 0 ||
+     board.getRows() != shadow.getRows() || board.getCols() != shadow.getCols())
+    return false;
+
+  unsigned long long target = (curr_gen - base_generation > num_gens) ?
+                              curr_gen - num_gens : base_generation;
+
+  // first entry that goes past the target, everything from it on is undone
+  size_t cut = entries.size();
+  size_t unwind_bytes = 0;
+  while(cut > 0 && entries[cut - 1].generation > target){
+    --cut;
+    unwind_bytes += entries[cut].bytes;
+  }
+
+  // replaying forward from a keyframe can beat undoing every delta
+  size_t board_bytes = sizeof(uint64_t) * board.getRows() * board.getRowWords();
+  size_t replay_bytes = 0;
+  size_t keyframe = cut;
+  for(size_t i = cut; i > 0 && replay_bytes + board_bytes < unwind_bytes; --i){
+    if(!entries[i - 1].keyframe.empty()){
+      keyframe = i - 1;
+      break;
+    }
+    replay_bytes += entries[i - 1].bytes;
+  }
+
+  if(keyframe < cut){
+    memcpy(board.getRow(0), entries[keyframe].keyframe.data(), board_bytes);
+    for(size_t i = keyframe + 1; i < cut; ++i)
+      applyEntry(entries[i], board);
+    memcpy(shadow.getRow(0), board.getRow(0), board_bytes);
+  }
+  else{
+    for(size_t i = entries.size(); i > cut; --i){
+      applyEntry(entries[i - 1], board);
+      applyEntry(entries[i - 1], shadow);
+    }
+  }
+
+  while(entries.size() > cut){
+    bytes_used -= entries.back().bytes;
+    entries.pop_back();
+  }
+
+  last_keyframe = base_generation;
+  for(size_t i = entries.size(); i > 0; --i){
+    if(!entries[i - 1].keyframe.empty()){
+      last_keyframe = entries[i - 1].generation;
+      break;
+    }
+  }
+
+  board.setGeneration(generationAfterLast());
+  shadow.setGeneration(board.getGeneration());
+  return true;
+}
+
+unsigned long long History::getOldestGeneration() const{
+  return base_generation;
+}
+
+size_t History::getBytesUsed() const{
+  return bytes_used;
+}
+
+size_t History::getBudget() const{
+  return budget;
+}
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef _HISTORY_H
+#define _HISTORY_H
+
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <vector>
+#include "LifeBoard.h"
+
+#define DEFAULT_HISTORY_BUDGET (64 << 20)
+#define DEFAULT_KEYFRAME_INTERVAL 64
+
+// Bounded record of how the board got to where it is, for stepping
+// backwards. Every recorded change (a step or a batch of edits) is kept
+// as the sparse XOR of the words it changed, so undoing it costs only
+// as much as the change did. Every keyframe_interval generations a full
+// copy is kept too, which makes going far back cheaper than unwinding
+// every delta. The oldest entries are dropped to stay under the budget.
+class History {
+  private:
+    struct Entry {
+      unsigned long long generation;   // of the board after this entry
+      std::vector<uint32_t> index;     // word offsets into the board
+      std::vector<uint64_t> bits;      // XOR of each of those words
+      std::vector<uint64_t> keyframe;  // whole board after this entry, or empty
+      size_t bytes;
+    };
+
+    LifeBoard shadow;      // the board as of the last entry
+    std::deque<Entry> entries;
+    unsigned long long base_generation;  // of the board before the first entry
+    unsigned long long last_keyframe;
+    size_t budget;
+    size_t bytes_used;
+    unsigned keyframe_interval;
+
+    static void applyEntry(const Entry& entry, LifeBoard& board);
+    unsigned long long generationAfterLast() const;
+
+  public:
+    History(size_t _budget = DEFAULT_HISTORY_BUDGET,
+            unsigned _keyframe_interval = DEFAULT_KEYFRAME_INTERVAL);
+
+    // Forgets everything and starts over from the board as it is
+    void reset(const LifeBoard& board);
+
+    // Records whatever changed since the last call, steps and edits alike
+    void record(const LifeBoard& board);
+
+    // Takes the board back num_gens generations, or as far as the
+    // history goes. Changes since the last record() aren't undone, so
+    // record first. Returns false if it couldn't go back at all.
+    bool stepBack(LifeBoard& board, unsigned long long num_gens = 1);
+
+    unsigned long long getOldestGeneration() const;
+    size_t getBytesUsed() const;
+    size_t getBudget() const;
+};
+
+#endif
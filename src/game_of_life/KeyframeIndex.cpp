@@ -0,0 +1,87 @@
+/*
+ *  Author: Abraham Cardenas / https://github.com/Abe-Crdns
+ */
+
+#ifndef _KEYFRAME_INDEX_CPP
+#define _KEYFRAME_INDEX_CPP
+
+#include <fstream>
+#include <sstream>
+#include "../lpc_lib/lpclib.h"
+#include "KeyframeIndex.h"
+#include "Snapshot.h"
+
+KeyframeIndex::KeyframeIndex(std::string _prefix){
+  prefix = _prefix;
+}
+
+bool KeyframeIndex::load(){
+  std::ifstream infile((prefix + ".index").c_str());
+  if(infile.fail())
+    return false;
+
+  keyframes.clear();
+
+  std::string line;
+  while(getline(infile, line)){
+    std::istringstream fields(line);
+    unsigned long long gen;
+    std::string filename;
+
+    if(!(fields >> gen >> filename))
+      Error("Improperly formed keyframe index " + prefix + ".index");
+    keyframes[gen] = filename;
+  }
+
+  return true;
+}
+
+void KeyframeIndex::clear(){
+  std::ofstream outfile((prefix + ".index").c_str(), std::ios::out|std::ios::trunc);
+  if(outfile.fail())
+    Error("Couldn't open keyframe index " + prefix + ".index");
+  keyframes.clear();
+}
+
+void KeyframeIndex::add(const LifeBoard& board){
+  std::ostringstream filename;
+  filename << prefix << "." << board.getGeneration() << ".snap";
+  writeSnapshot(filename.str(), board);
+
+  // the snapshot is complete before the index points at it
+  std::ofstream outfile((prefix + ".index").c_str(), std::ios::out|std::ios::app);
+  if(outfile.fail())
+    Error("Couldn't open keyframe index " + prefix + ".index");
+  outfile << board.getGeneration() << " " << filename.str() << "\n";
+
+  keyframes[board.getGeneration()] = filename.str();
+}
+
+bool KeyframeIndex::nearestKeyframe(unsigned long long gen,
+                                    unsigned long long* keyframe_gen) const{
+  std::map<unsigned long long, std::string>::const_iterator it = keyframes.upper_bound(gen);
+  if(it == keyframes.begin())
+    return false;
+
+  --it;
+  *keyframe_gen = it->first;
+  return true;
+}
+
+bool KeyframeIndex::seek(unsigned long long gen, LifeBoard& board, WorkerPool* pool){
+  unsigned long long keyframe_gen;
+  if(!nearestKeyframe(gen, &keyframe_gen))
+    return false;
+
+  readSnapshot(keyframes[keyframe_gen], board);
+  while(board.getGeneration() < gen)
+    board.step(pool);
+
+  return true;
+}
+
+unsigned KeyframeIndex::getNumKeyframes() const{
+  return keyframes.size();
+}
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef _KEYFRAME_INDEX_H
+#define _KEYFRAME_INDEX_H
+
+#include <map>
+#include <string>
+#include "LifeBoard.h"
+#include "private/WorkerPool.h"
+
+// Snapshots taken during a run so any later generation can be reached
+// without simulating from the start. Each keyframe is written to
+// <prefix>.<generation>.snap and listed in <prefix>.index, one
+// "<generation> <file>" line per keyframe.
+class KeyframeIndex {
+  private:
+    std::string prefix;
+    std::map<unsigned long long, std::string> keyframes;
+
+  public:
+    KeyframeIndex(std::string _prefix);
+
+    // Reads the index file, returns false if there isn't one
+    bool load();
+
+    // Starts a new, empty index file
+    void clear();
+
+    // Snapshots the board and appends it to the index
+    void add(const LifeBoard& board);
+
+    // Maps the latest keyframe at or before gen and steps the board
+    // the rest of the way. Returns false if every keyframe is later.
+    bool seek(unsigned long long gen, LifeBoard& board, WorkerPool* pool = nullptr);
+
+    // Generation of the keyframe a seek to gen would start from
+    bool nearestKeyframe(unsigned long long gen, unsigned long long* keyframe_gen) const;
+
+    unsigned getNumKeyframes() const;
+};
+
+#endif
@@ -0,0 +1,559 @@
+/*
+ *  Author: Abraham Cardenas / https://github.com/Abe-Crdns
+ */
+
+#ifndef _LIFE_BOARD_CPP
+#define _LIFE_BOARD_CPP
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <sys/mman.h>
+#include "LifeBoard.h"
+#include "private/LifeRule.h"
+
+#define CACHE_LINE_WORDS 8
+
+// Fewest words worth handing to a pool thread, small boards step inline
+static const unsigned MIN_BAND_WORDS = 4096;
+
+LifeBoard::LifeBoard(unsigned _rows, unsigned _cols, BoundaryScheme scheme){
+  curr = next = zero_row = nullptr;
+  snapshot_map = nullptr;
+  snapshot_map_size = 0;
+  snapshot_rows = nullptr;
+  bound_scheme = scheme;
+  generation = 0;
+  resize(_rows, _cols);
+}
+
+LifeBoard::LifeBoard(const LifeBoard& other){
+  curr = next = zero_row = nullptr;
+  snapshot_map = nullptr;
+  snapshot_map_size = 0;
+  snapshot_rows = nullptr;
+  copyContentsFrom(other);
+}
+
+LifeBoard::~LifeBoard(){
+  release();
+}
+
+const LifeBoard& LifeBoard::operator=(const LifeBoard& other){
+  if(this != &other){
+    release();
+    copyContentsFrom(other);
+  }
+  return *this;
+}
+
+void LifeBoard::copyContentsFrom(const LifeBoard& other){
+  bound_scheme = other.bound_scheme;
+  resize(other.rows, other.cols);
+  generation = other.generation;
+
+  if(curr != nullptr)
+    memcpy(curr, other.curr, sizeof(uint64_t) * rows * row_words);
+}
+
+void LifeBoard::allocate(){
+  size_t buf_size = sizeof(uint64_t) * rows * row_words;
+  void* buffers[3] = { nullptr, nullptr, nullptr };
+  size_t sizes[3] = { buf_size, buf_size, sizeof(uint64_t) * row_words };
+
+  for(unsigned i = 0; i < 3; ++i){
+    if(posix_memalign(&buffers[i], CACHE_LINE_WORDS * sizeof(uint64_t), sizes[i]) != 0){
+      std::cerr << "bad_alloc caught: LifeBoard of " << rows << "x" << cols << std::endl;
+      exit(1);
+    }
+    memset(buffers[i], 0, sizes[i]);
+  }
+
+  curr = (uint64_t*)buffers[0];
+  next = (uint64_t*)buffers[1];
+  zero_row = (uint64_t*)buffers[2];
+}
+
+void LifeBoard::release(){
+  if(snapshot_map != nullptr){
+    // the other buffer is an anonymous mapping the same size
+    uint64_t* anon = (curr == snapshot_rows) ? next : curr;
+    munmap(anon, sizeof(uint64_t) * rows * row_words);
+    munmap(snapshot_map, snapshot_map_size);
+    snapshot_map = nullptr;
+    snapshot_rows = nullptr;
+  }
+  else{
+    free(curr);
+    free(next);
+  }
+
+  free(zero_row);
+  curr = next = zero_row = nullptr;
+}
+
+void LifeBoard::adoptMapping(void* map, size_t map_size, size_t rows_offset,
+                             unsigned _rows, unsigned _cols){
+  release();
+  setDimensions(_rows, _cols);
+  generation = 0;
+
+  size_t buf_size = sizeof(uint64_t) * rows * row_words;
+  void* anon = mmap(nullptr, buf_size, PROT_READ|PROT_WRITE,
+                    MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+  void* zero = nullptr;
+
+  if(anon == MAP_FAILED ||
+     posix_memalign(&zero, CACHE_LINE_WORDS * sizeof(uint64_t), sizeof(uint64_t) * row_words) != 0){
+    std::cerr << "bad_alloc caught: LifeBoard of " << rows << "x" << cols << std::endl;
+    exit(1);
+  }
+  memset(zero, 0, sizeof(uint64_t) * row_words);
+
+  snapshot_map = map;
+  snapshot_map_size = map_size;
+  snapshot_rows = (uint64_t*)((char*)map + rows_offset);
+
+  curr = snapshot_rows;
+  next = (uint64_t*)anon;
+  zero_row = (uint64_t*)zero;
+}
+
+unsigned LifeBoard::getRows() const{
+  return rows;
+}
+
+unsigned LifeBoard::getCols() const{
+  return cols;
+}
+
+unsigned LifeBoard::getRowWords() const{
+  return row_words;
+}
+
+unsigned LifeBoard::getUsedWords() const{
+  return used_words;
+}
+
+BoundaryScheme LifeBoard::getBoundScheme() const{
+  return bound_scheme;
+}
+
+unsigned long long LifeBoard::getGeneration() const{
+  return generation;
+}
+
+void LifeBoard::setBoundScheme(BoundaryScheme scheme){
+  bound_scheme = scheme;
+}
+
+void LifeBoard::setGeneration(unsigned long long gen){
+  generation = gen;
+}
+
+unsigned LifeBoard::rowWordsFor(unsigned _cols){
+  unsigned words = (_cols + 63) / 64;
+  return ((words + CACHE_LINE_WORDS - 1) / CACHE_LINE_WORDS) * CACHE_LINE_WORDS;
+}
+
+void LifeBoard::setDimensions(unsigned _rows, unsigned _cols){
+  rows = _rows;
+  cols = _cols;
+  used_words = (cols + 63) / 64;
+  row_words = rowWordsFor(cols);
+  last_word_mask = (cols % 64 == 0) ? ~0ULL : (1ULL << (cols % 64)) - 1;
+}
+
+void LifeBoard::resize(unsigned _rows, unsigned _cols){
+  release();
+  setDimensions(_rows, _cols);
+  generation = 0;
+
+  if(rows > 0 && cols > 0)
+    allocate();
+}
+
+void LifeBoard::clear(){
+  if(curr != nullptr)
+    memset(curr, 0, sizeof(uint64_t) * rows * row_words);
+  generation = 0;
+}
+
+bool LifeBoard::getCell(unsigned row, unsigned col) const{
+  return (curr[((size_t)row * row_words) + (col / 64)] >> (col % 64)) & 1;
+}
+
+void LifeBoard::setCell(unsigned row, unsigned col, bool alive){
+  uint64_t bit = 1ULL << (col % 64);
+
+  if(alive)
+    curr[((size_t)row * row_words) + (col / 64)] |= bit;
+  else
+    curr[((size_t)row * row_words) + (col / 64)] &= ~bit;
+}
+
+void LifeBoard::toggleCell(unsigned row, unsigned col){
+  curr[((size_t)row * row_words) + (col / 64)] ^= 1ULL << (col % 64);
+}
+
+void LifeBoard::setRun(unsigned row, unsigned col, unsigned count, bool alive){
+  uint64_t* words = getRow(row);
+  unsigned end = col + count;
+
+  while(col < end){
+    unsigned bit = col % 64;
+    unsigned span = (end - col < 64 - bit) ? end - col : 64 - bit;
+    uint64_t mask = (span == 64) ? ~0ULL : ((1ULL << span) - 1) << bit;
+
+    if(alive)
+      words[col / 64] |= mask;
+    else
+      words[col / 64] &= ~mask;
+    col += span;
+  }
+}
+
+unsigned LifeBoard::nextCell(unsigned row, unsigned col, bool alive) const{
+  const uint64_t* words = getRow(row);
+
+  while(col < cols){
+    uint64_t bits = alive ? words[col / 64] : ~words[col / 64];
+    bits &= ~0ULL << (col % 64);
+
+    if(bits != 0){
+      unsigned found = ((col / 64) * 64) + __builtin_ctzll(bits);
+      return found < cols ? found : cols;
+    }
+    col = ((col / 64) + 1) * 64;
+  }
+
+  return cols;
+}
+
+const uint64_t* LifeBoard::getRow(unsigned row) const{
+  return &curr[(size_t)row * row_words];
+}
+
+uint64_t* LifeBoard::getRow(unsigned row){
+  return &curr[(size_t)row * row_words];
+}
+
+const uint64_t* LifeBoard::getPreviousRow(unsigned row) const{
+  return &next[(size_t)row * row_words];
+}
+
+// Shifts whole pattern words into place rather than going cell by cell
+void LifeBoard::stamp(const LifeBoard& pattern, int top, int left){
+  stamp(pattern.getRow(0), pattern.rows, pattern.used_words, pattern.row_words, top, left);
+}
+
+void LifeBoard::stamp(const uint64_t* pat_bits, unsigned pat_rows, unsigned pat_words,
+                      size_t stride, int top, int left){
+  for(unsigned i = 0; i < pat_rows; ++i){
+    int dest_row = top + (int)i;
+    if(dest_row < 0)
+      continue;
+    if(dest_row >= (int)rows)
+      break;
+
+    const uint64_t* src = pat_bits + (i * stride);
+    uint64_t* dest = getRow(dest_row);
+
+    for(unsigned k = 0; k < pat_words; ++k){
+      uint64_t bits = src[k];
+      long long dest_col = (long long)left + (64LL * k);
+
+      if(bits == 0 || dest_col <= -64)
+        continue;
+      if(dest_col >= (long long)cols)
+        break;
+
+      if(dest_col < 0){
+        dest[0] |= bits >> (-dest_col);
+        continue;
+      }
+
+      unsigned word = dest_col / 64, shift = dest_col % 64;
+      dest[word] |= bits << shift;
+      if(shift != 0 && word + 1 < used_words)
+        dest[word + 1] |= bits >> (64 - shift);
+    }
+
+    dest[used_words - 1] &= last_word_mask;
+  }
+}
+
+unsigned long long LifeBoard::population() const{
+  unsigned long long count = 0;
+
+  for(unsigned i = 0; i < rows; ++i){
+    const uint64_t* row = getRow(i);
+    for(unsigned k = 0; k < used_words; ++k)
+      count += __builtin_popcountll(row[k]);
+  }
+
+  return count;
+}
+
+bool LifeBoard::boundingBox(unsigned* top, unsigned* left,
+                            unsigned* bottom, unsigned* right) const{
+  bool found = false;
+  unsigned min_word = used_words, max_word = 0;
+  uint64_t min_bits = 0, max_bits = 0;
+
+  for(unsigned i = 0; i < rows; ++i){
+    const uint64_t* row = getRow(i);
+    for(unsigned k = 0; k < used_words; ++k){
+      if(row[k] == 0)
+        continue;
+
+      if(!found){
+        *top = i;
+        found = true;
+      }
+      *bottom = i;
+
+      if(k < min_word){
+        min_word = k;
+        min_bits = row[k];
+      }
+      else if(k == min_word)
+        min_bits |= row[k];
+
+      if(k > max_word || max_bits == 0){
+        max_word = k;
+        max_bits = row[k];
+      }
+      else if(k == max_word)
+        max_bits |= row[k];
+    }
+  }
+
+  if(found){
+    *left = (min_word * 64) + __builtin_ctzll(min_bits);
+    *right = (max_word * 64) + (63 - __builtin_clzll(max_bits));
+  }
+
+  return found;
+}
+
+const uint64_t* LifeBoard::rowAbove(unsigned row) const{
+  if(row > 0)
+    return getRow(row - 1);
+
+  switch(bound_scheme){
+    case Donut:
+      return getRow(rows - 1);
+    case Mirror:
+      return getRow(0);
+    default:
+      return zero_row;
+  }
+}
+
+const uint64_t* LifeBoard::rowBelow(unsigned row) const{
+  if(row + 1 < rows)
+    return getRow(row + 1);
+
+  switch(bound_scheme){
+    case Donut:
+      return getRow(0);
+    case Mirror:
+      return getRow(rows - 1);
+    default:
+      return zero_row;
+  }
+}
+
+// The cells just outside the first and last column of a row, as seen
+// from inside the board under the current boundary scheme
+void LifeBoard::edgeBits(const uint64_t* row, uint64_t* west_in, uint64_t* east_in) const{
+  uint64_t first = row[0] & 1;
+  uint64_t last = (row[(cols - 1) / 64] >> ((cols - 1) % 64)) & 1;
+
+  switch(bound_scheme){
+    case Donut:
+      *west_in = last;
+      *east_in = first;
+      break;
+    case Mirror:
+      *west_in = first;
+      *east_in = last;
+      break;
+    default:
+      *west_in = *east_in = 0;
+      break;
+  }
+}
+
+static void clearStats(StepStats* stats){
+  stats->population = stats->births = stats->deaths = stats->active_tiles = 0;
+  stats->empty = true;
+  stats->top = stats->left = stats->bottom = stats->right = 0;
+}
+
+static void mergeStats(StepStats* into, const StepStats& from){
+  into->population += from.population;
+  into->births += from.births;
+  into->deaths += from.deaths;
+  into->active_tiles += from.active_tiles;
+
+  if(from.empty)
+    return;
+
+  if(into->empty){
+    into->empty = false;
+    into->top = from.top;
+    into->left = from.left;
+    into->bottom = from.bottom;
+    into->right = from.right;
+    return;
+  }
+
+  if(from.top < into->top) into->top = from.top;
+  if(from.left < into->left) into->left = from.left;
+  if(from.bottom > into->bottom) into->bottom = from.bottom;
+  if(from.right > into->right) into->right = from.right;
+}
+
+void LifeBoard::stepRow(const uint64_t* above, const uint64_t* row,
+                        const uint64_t* below, uint64_t* out,
+                        unsigned row_index, StepStats* stats,
+                        uint8_t* changed_tiles) const{
+  uint64_t a_west, a_east, b_west, b_east, c_west, c_east;
+  edgeBits(above, &a_west, &a_east);
+  edgeBits(row, &b_west, &b_east);
+  edgeBits(below, &c_west, &c_east);
+
+  unsigned east_shift = (cols - 1) % 64;
+  unsigned last = used_words - 1;
+
+  for(unsigned k = 0; k < used_words; ++k){
+    uint64_t a = above[k], b = row[k], c = below[k];
+
+    uint64_t aw = (a << 1) | (k > 0 ? above[k-1] >> 63 : a_west);
+    uint64_t bw = (b << 1) | (k > 0 ? row[k-1] >> 63 : b_west);
+    uint64_t cw = (c << 1) | (k > 0 ? below[k-1] >> 63 : c_west);
+    uint64_t ae = (a >> 1) | (k < last ? above[k+1] << 63 : a_east << east_shift);
+    uint64_t be = (b >> 1) | (k < last ? row[k+1] << 63 : b_east << east_shift);
+    uint64_t ce = (c >> 1) | (k < last ? below[k+1] << 63 : c_east << east_shift);
+
+    uint64_t o = lifeRule(aw, a, ae, bw, b, be, cw, c, ce);
+    if(k == last)
+      o &= last_word_mask;
+    out[k] = o;
+
+    // the word is still in a register, counting it here saves
+    // another pass over the board
+    if(stats != nullptr){
+      if(o != 0){
+        unsigned low = (k * 64) + __builtin_ctzll(o);
+        unsigned high = (k * 64) + (63 - __builtin_clzll(o));
+
+        stats->population += __builtin_popcountll(o);
+        if(stats->empty){
+          stats->empty = false;
+          stats->top = row_index;
+          stats->left = low;
+          stats->right = high;
+        }
+        if(low < stats->left) stats->left = low;
+        if(high > stats->right) stats->right = high;
+        stats->bottom = row_index;
+      }
+      if(o != b){
+        stats->births += __builtin_popcountll(o & ~b);
+        stats->deaths += __builtin_popcountll(b & ~o);
+        changed_tiles[k / TILE_WORDS] = 1;
+      }
+    }
+  }
+}
+
+void LifeBoard::stepRows(unsigned first_row, unsigned last_row, StepStats* stats){
+  if(stats == nullptr){
+    for(unsigned i = first_row; i < last_row; ++i)
+      stepRow(rowAbove(i), getRow(i), rowBelow(i), &next[(size_t)i * row_words]);
+    return;
+  }
+
+  // bands start on a tile boundary, so no tile is split between them
+  unsigned num_lines = row_words / TILE_WORDS;
+  std::vector<uint8_t> changed_tiles(num_lines, 0);
+
+  for(unsigned i = first_row; i < last_row; ++i){
+    stepRow(rowAbove(i), getRow(i), rowBelow(i), &next[(size_t)i * row_words],
+            i, stats, changed_tiles.data());
+
+    if((i + 1) % TILE_ROWS == 0 || i + 1 == last_row){
+      for(unsigned k = 0; k < num_lines; ++k){
+        stats->active_tiles += changed_tiles[k];
+        changed_tiles[k] = 0;
+      }
+    }
+  }
+}
+
+void LifeBoard::step(WorkerPool* pool, StepStats* stats){
+  if(stats != nullptr)
+    clearStats(stats);
+  if(rows == 0 || cols == 0)
+    return;
+
+  unsigned num_bands = 1;
+  if(pool != nullptr && pool->getNumThreads() > 1){
+    size_t max_bands = ((size_t)rows * used_words) / MIN_BAND_WORDS;
+    num_bands = pool->getNumThreads() * 4;
+    if(num_bands > max_bands)
+      num_bands = max_bands;
+    if(num_bands > rows)
+      num_bands = rows;
+  }
+
+  if(num_bands <= 1)
+    stepRows(0, rows, stats);
+  else{
+    unsigned band_rows = (rows + num_bands - 1) / num_bands;
+    std::vector<StepStats> band_stats;
+
+    if(stats != nullptr){
+      band_rows = ((band_rows + TILE_ROWS - 1) / TILE_ROWS) * TILE_ROWS;
+      band_stats.resize(num_bands);
+      for(unsigned i = 0; i < num_bands; ++i)
+        clearStats(&band_stats[i]);
+    }
+
+    pool->run(num_bands, [this, band_rows, stats, &band_stats](unsigned band){
+      unsigned first_row = band * band_rows;
+      unsigned last_row = first_row + band_rows;
+      if(last_row > rows)
+        last_row = rows;
+      if(first_row < last_row)
+        stepRows(first_row, last_row, stats != nullptr ? &band_stats[band] : nullptr);
+    });
+
+    // bands are in row order, so merging keeps the first top row
+    for(unsigned i = 0; i < band_stats.size(); ++i)
+      mergeStats(stats, band_stats[i]);
+  }
+
+  uint64_t* tmp = curr;
+  curr = next;
+  next = tmp;
+  ++generation;
+}
+
+bool LifeBoard::advanceTo(const LifeBoard& stepped){
+  if(stepped.rows != rows || stepped.cols != cols)
+    return false;
+
+  uint64_t* tmp = curr;
+  curr = next;
+  next = tmp;
+  memcpy(curr, stepped.curr, sizeof(uint64_t) * rows * row_words);
+  generation = stepped.generation;
+  return true;
+}
+
+#endif
@@ -0,0 +1,139 @@
+#ifndef _LIFE_BOARD_H
+#define _LIFE_BOARD_H
+
+#include <cstdint>
+#include <cstddef>
+#include "private/WorkerPool.h"
+
+enum BoundaryScheme{
+  Flat, Donut, Mirror
+};
+
+// Tiles are 64 rows by one 64-byte line of words
+#define TILE_ROWS 64
+#define TILE_WORDS 8
+
+// What a step produced, gathered while stepping
+struct StepStats {
+  unsigned long long population;
+  unsigned long long births;
+  unsigned long long deaths;
+  unsigned long long active_tiles;    // tiles with at least one change
+  bool empty;
+  unsigned top, left, bottom, right;  // live cell bounds if not empty
+};
+
+// Bit-packed Game of Life board. Each row is stored as 64-bit words,
+// bit j of word k holding column (64 * k) + j, and every row starts
+// on a 64-byte boundary. Nothing in here touches the graphics window,
+// so it can be stepped headless as well as behind GameOfLife.
+class LifeBoard {
+  private:
+    unsigned rows;
+    unsigned cols;
+    unsigned used_words;    // words that hold columns
+    unsigned row_words;     // used_words padded to a 64-byte line
+    uint64_t last_word_mask;
+
+    uint64_t* curr;
+    uint64_t* next;
+    uint64_t* zero_row;
+
+    // set while one buffer lives in a mapped snapshot file
+    void* snapshot_map;
+    size_t snapshot_map_size;
+    uint64_t* snapshot_rows;
+
+    BoundaryScheme bound_scheme;
+    unsigned long long generation;
+
+    void setDimensions(unsigned _rows, unsigned _cols);
+    void allocate();
+    void release();
+    void copyContentsFrom(const LifeBoard& other);
+
+    const uint64_t* rowAbove(unsigned row) const;
+    const uint64_t* rowBelow(unsigned row) const;
+    void edgeBits(const uint64_t* row, uint64_t* west_in, uint64_t* east_in) const;
+    void stepRow(const uint64_t* above, const uint64_t* row,
+                 const uint64_t* below, uint64_t* out,
+                 unsigned row_index = 0, StepStats* stats = nullptr,
+                 uint8_t* changed_tiles = nullptr) const;
+    void stepRows(unsigned first_row, unsigned last_row, StepStats* stats = nullptr);
+
+  public:
+    LifeBoard(unsigned _rows = 0, unsigned _cols = 0, BoundaryScheme scheme = Flat);
+    LifeBoard(const LifeBoard& other);
+    ~LifeBoard();
+
+    const LifeBoard& operator=(const LifeBoard& other);
+
+    unsigned getRows() const;
+    unsigned getCols() const;
+    unsigned getRowWords() const;
+    unsigned getUsedWords() const;
+    BoundaryScheme getBoundScheme() const;
+    unsigned long long getGeneration() const;
+
+    void setBoundScheme(BoundaryScheme scheme);
+    void setGeneration(unsigned long long gen);
+
+    // Discards the current contents
+    void resize(unsigned _rows, unsigned _cols);
+    void clear();
+
+    // Words per row, padded to a 64-byte line, for a board this wide
+    static unsigned rowWordsFor(unsigned _cols);
+
+    // Discards the current contents and uses the rows found rows_offset
+    // bytes into a private, writable mmap of map_size bytes as the
+    // current generation. Nothing is copied, pages load as they're
+    // touched, and the board unmaps it once it's done with it.
+    void adoptMapping(void* map, size_t map_size, size_t rows_offset,
+                      unsigned _rows, unsigned _cols);
+
+    bool getCell(unsigned row, unsigned col) const;
+    void setCell(unsigned row, unsigned col, bool alive);
+    void toggleCell(unsigned row, unsigned col);
+
+    // Sets count cells starting at (row, col), a word at a time
+    void setRun(unsigned row, unsigned col, unsigned count, bool alive = true);
+
+    // First column at or after col whose cell is alive (or dead),
+    // getCols() if there is none
+    unsigned nextCell(unsigned row, unsigned col, bool alive = true) const;
+
+    const uint64_t* getRow(unsigned row) const;
+    uint64_t* getRow(unsigned row);
+
+    // The row as it was before the last step, edits made
+    // since then aren't reflected
+    const uint64_t* getPreviousRow(unsigned row) const;
+
+    // ORs the pattern's live cells in with its top left corner at
+    // (top, left), clipping whatever falls off the board
+    void stamp(const LifeBoard& pattern, int top, int left);
+
+    // Same for pat_rows rows of pat_words packed words each, row i
+    // starting at pat_bits + (i * stride)
+    void stamp(const uint64_t* pat_bits, unsigned pat_rows, unsigned pat_words,
+               size_t stride, int top, int left);
+
+    unsigned long long population() const;
+
+    // Smallest rectangle holding every live cell, bounds inclusive.
+    // Returns false if the board is empty.
+    bool boundingBox(unsigned* top, unsigned* left,
+                     unsigned* bottom, unsigned* right) const;
+
+    // Advances one generation, splitting the rows across the pool.
+    // The new generation's stats are filled in if stats is given.
+    void step(WorkerPool* pool = nullptr, StepStats* stats = nullptr);
+
+    // Takes on a generation stepped elsewhere from a copy of this
+    // board, as if stepped here: the current rows become the previous
+    // ones. Returns false, changing nothing, if the sizes differ.
+    bool advanceTo(const LifeBoard& stepped);
+};
+
+#endif
@@ -0,0 +1,645 @@
+/*
+ *  Author: Abraham Cardenas / https://github.com/Abe-Crdns
+ */
+
+#ifndef _LIFE_ENSEMBLE_CPP
+#define _LIFE_ENSEMBLE_CPP
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+#include "../lpc_lib/lpclib.h"
+#include "BatchRun.h"
+#include "LifeEnsemble.h"
+#include "private/LifeRule.h"
+#include "private/SplitMix.h"
+#include "private/Timer.h"
+
+LifeEnsemble::LifeEnsemble(unsigned _num_boards, unsigned _rows, unsigned _cols,
+                           BoundaryScheme scheme){
+  if(_rows == 0 || _cols == 0)
+    Error("An ensemble's boards need at least one cell");
+
+  num_boards = _num_boards;
+  num_groups = (num_boards + 63) / 64;
+  rows = _rows;
+  cols = _cols;
+  stride = cols + 2;
+  group_words = (size_t)(rows + 2) * stride;
+  board_words = (((size_t)rows * cols) + 63) / 64;
+  bound_scheme = scheme;
+  generation = 0;
+  saved_gen = older_gen = 0;
+
+  prev.assign(num_groups * group_words, 0);
+  curr.assign(num_groups * group_words, 0);
+  next.assign(num_groups * group_words, 0);
+  want_empty.assign(num_groups, 0);
+  want_stable.assign(num_groups, 0);
+  want_period2.assign(num_groups, 0);
+  want_period.assign(num_groups, 0);
+  conditions.assign(num_boards, 0);
+  max_gens.assign(num_boards, 0);
+  halt_gen.assign(num_boards, 0);
+  halt_reason.assign(num_boards, ehLimit);
+  halt_period.assign(num_boards, 0);
+  rules.assign(num_boards, conwayRule());
+  lane_birth.assign(num_groups * 9, 0);
+  lane_survive.assign(num_groups * 9, 0);
+  group_counts.assign(num_groups, 0);
+  group_conway.assign(num_groups, 0);
+
+  // board b starts out in lane b
+  lane_board.assign(num_groups * 64, NO_BOARD);
+  board_lane.resize(num_boards);
+  for(unsigned b = 0; b < num_boards; ++b)
+    lane_board[b] = board_lane[b] = b;
+  for(unsigned lane = 0; lane < num_groups * 64; ++lane)
+    setLaneRule(lane, conwayRule());
+
+  // the lanes past the last board start out halted and stay empty
+  halted.assign(num_groups, 0);
+  if(num_boards % 64 != 0)
+    halted[num_groups - 1] = ~0ULL << (num_boards % 64);
+}
+
+unsigned LifeEnsemble::getNumBoards() const{
+  return num_boards;
+}
+
+unsigned LifeEnsemble::getRows() const{
+  return rows;
+}
+
+unsigned LifeEnsemble::getCols() const{
+  return cols;
+}
+
+unsigned long long LifeEnsemble::getGeneration() const{
+  return generation;
+}
+
+size_t LifeEnsemble::cellIndex(unsigned lane, unsigned row, unsigned col) const{
+  return ((lane / 64) * group_words) + ((size_t)(row + 1) * stride) + (col + 1);
+}
+
+bool LifeEnsemble::getCell(unsigned board, unsigned row, unsigned col) const{
+  unsigned lane = board_lane[board];
+  if(lane == NO_BOARD){
+    size_t bit = ((size_t)row * cols) + col;
+    return (retired[(board * board_words) + (bit / 64)] >> (bit % 64)) & 1;
+  }
+  return (curr[cellIndex(lane, row, col)] >> (lane % 64)) & 1;
+}
+
+void LifeEnsemble::setCell(unsigned board, unsigned row, unsigned col, bool alive){
+  unsigned lane = board_lane[board];
+  uint64_t* word;
+  uint64_t bit;
+
+  if(lane == NO_BOARD){
+    size_t index = ((size_t)row * cols) + col;
+    word = &retired[(board * board_words) + (index / 64)];
+    bit = 1ULL << (index % 64);
+  }
+  else{
+    word = &curr[cellIndex(lane, row, col)];
+    bit = 1ULL << (lane % 64);
+  }
+
+  if(alive)
+    *word |= bit;
+  else
+    *word &= ~bit;
+}
+
+void LifeEnsemble::loadBoard(unsigned board, const LifeBoard& source){
+  if(source.getRows() != rows || source.getCols() != cols)
+    Error("Board doesn't match the ensemble's size");
+
+  for(unsigned i = 0; i < rows; ++i){
+    for(unsigned j = 0; j < cols; ++j)
+      setCell(board, i, j, source.getCell(i, j));
+  }
+}
+
+void LifeEnsemble::storeBoard(unsigned board, LifeBoard& dest) const{
+  if(dest.getRows() != rows || dest.getCols() != cols)
+    dest.resize(rows, cols);
+  else
+    dest.clear();
+
+  for(unsigned i = 0; i < rows; ++i){
+    for(unsigned j = 0; j < cols; ++j){
+      if(getCell(board, i, j))
+        dest.setCell(i, j, true);
+    }
+  }
+}
+
+void LifeEnsemble::loadBoardAll(const LifeBoard& source){
+  if(source.getRows() != rows || source.getCols() != cols)
+    Error("Board doesn't match the ensemble's size");
+
+  for(unsigned g = 0; g < num_groups; ++g){
+    uint64_t* grid = &curr[g * group_words];
+    uint64_t lanes = ~halted[g];
+
+    for(unsigned i = 0; i < rows; ++i){
+      uint64_t* row = grid + ((size_t)(i + 1) * stride);
+      for(unsigned j = 0; j < cols; ++j)
+        row[j + 1] = source.getCell(i, j) ? row[j + 1] | lanes : row[j + 1] & ~lanes;
+    }
+  }
+}
+
+void LifeEnsemble::randomize(unsigned long long seed){
+  uint64_t state = seed;
+
+  for(unsigned g = 0; g < num_groups; ++g){
+    uint64_t* grid = &curr[g * group_words];
+    uint64_t lanes = ~halted[g];
+
+    for(unsigned i = 1; i <= rows; ++i){
+      for(unsigned j = 1; j <= cols; ++j)
+        grid[(i * stride) + j] = (grid[(i * stride) + j] & ~lanes) | (splitMix64(&state) & lanes);
+    }
+  }
+}
+
+void LifeEnsemble::setHalt(unsigned board, unsigned _conditions, unsigned long long _max_gens){
+  conditions[board] = _conditions;
+  max_gens[board] = _max_gens;
+
+  unsigned lane = board_lane[board];
+  if(lane == NO_BOARD)
+    return;
+
+  unsigned g = lane / 64;
+  uint64_t bit = 1ULL << (lane % 64);
+  want_empty[g] = (_conditions & ehEmpty) ? want_empty[g] | bit : want_empty[g] & ~bit;
+  want_stable[g] = (_conditions & ehStable) ? want_stable[g] | bit : want_stable[g] & ~bit;
+  want_period2[g] = (_conditions & ehPeriod2) ? want_period2[g] | bit : want_period2[g] & ~bit;
+  want_period[g] = (_conditions & ehPeriod) ? want_period[g] | bit : want_period[g] & ~bit;
+}
+
+void LifeEnsemble::setHaltAll(unsigned _conditions, unsigned long long _max_gens){
+  for(unsigned b = 0; b < num_boards; ++b)
+    setHalt(b, _conditions, _max_gens);
+}
+
+// Writes the rule into the lane's bit of its group's masks, and works
+// out again which counts the group needs and whether it's all B3/S23
+void LifeEnsemble::setLaneRule(unsigned lane, BSRule rule){
+  unsigned g = lane / 64;
+  uint64_t bit = 1ULL << (lane % 64);
+  uint64_t* birth = &lane_birth[g * 9];
+  uint64_t* survive = &lane_survive[g * 9];
+  BSRule conway = conwayRule();
+
+  unsigned counts = 0;
+  bool conway_only = true;
+  for(unsigned n = 0; n <= 8; ++n){
+    birth[n] = (rule.birth & (1 << n)) ? birth[n] | bit : birth[n] & ~bit;
+    survive[n] = (rule.survive & (1 << n)) ? survive[n] | bit : survive[n] & ~bit;
+    if(birth[n] | survive[n])
+      counts |= 1 << n;
+    conway_only = conway_only && birth[n] == ((conway.birth & (1 << n)) ? ~0ULL : 0) &&
+                  survive[n] == ((conway.survive & (1 << n)) ? ~0ULL : 0);
+  }
+  group_counts[g] = counts;
+  group_conway[g] = conway_only;
+}
+
+void LifeEnsemble::setRule(unsigned board, BSRule rule){
+  rules[board] = rule;
+  if(board_lane[board] != NO_BOARD)
+    setLaneRule(board_lane[board], rule);
+}
+
+BSRule LifeEnsemble::getRule(unsigned board) const{
+  return rules[board];
+}
+
+bool LifeEnsemble::isHalted(unsigned board) const{
+  unsigned lane = board_lane[board];
+  return lane == NO_BOARD || ((halted[lane / 64] >> (lane % 64)) & 1);
+}
+
+unsigned long long LifeEnsemble::getHaltGeneration(unsigned board) const{
+  return halt_gen[board];
+}
+
+EnsembleHalt LifeEnsemble::getHaltReason(unsigned board) const{
+  return (EnsembleHalt)halt_reason[board];
+}
+
+unsigned long long LifeEnsemble::getHaltPeriod(unsigned board) const{
+  return halt_period[board];
+}
+
+unsigned long long LifeEnsemble::population(unsigned board) const{
+  unsigned long long count = 0;
+  for(unsigned i = 0; i < rows; ++i){
+    for(unsigned j = 0; j < cols; ++j)
+      count += getCell(board, i, j);
+  }
+  return count;
+}
+
+// Copies the cells just outside the board into the halo under the
+// boundary scheme, corners included. A flat board's halo stays dead.
+void LifeEnsemble::fillHalo(uint64_t* grid) const{
+  if(bound_scheme == Flat)
+    return;
+
+  bool donut = (bound_scheme == Donut);
+  uint64_t* top = grid;
+  uint64_t* bottom = grid + ((size_t)(rows + 1) * stride);
+  const uint64_t* top_src = grid + ((size_t)(donut ? rows : 1) * stride);
+  const uint64_t* bottom_src = grid + ((size_t)(donut ? 1 : rows) * stride);
+  std::copy(top_src, top_src + stride, top);
+  std::copy(bottom_src, bottom_src + stride, bottom);
+
+  for(unsigned i = 0; i < rows + 2; ++i){
+    uint64_t* row = grid + ((size_t)i * stride);
+    row[0] = row[donut ? cols : 1];
+    row[cols + 1] = row[donut ? 1 : cols];
+  }
+}
+
+void LifeEnsemble::stepGroup(unsigned group){
+  size_t base = group * group_words;
+  uint64_t* grid = &curr[base];
+  uint64_t* out_grid = &next[base];
+  const uint64_t* old_grid = &prev[base];
+  const uint64_t* saved_grid = saved.empty() ? nullptr : &saved[base];
+  const uint64_t* older_grid = older.empty() ? nullptr : &older[base];
+  const uint64_t* birth = &lane_birth[group * 9];
+  const uint64_t* survive = &lane_survive[group * 9];
+  unsigned counts = group_counts[group];
+  bool conway = group_conway[group];
+  uint64_t frozen = halted[group];
+
+  if(frozen == ~0ULL){
+    std::copy(grid, grid + group_words, out_grid);
+    return;
+  }
+
+  fillHalo(grid);
+
+  uint64_t any_alive = 0, changed = 0, changed2 = 0, changed_saved = 0, changed_older = 0;
+  for(unsigned i = 1; i <= rows; ++i){
+    const uint64_t* above = grid + ((size_t)(i - 1) * stride);
+    const uint64_t* row = above + stride;
+    const uint64_t* below = row + stride;
+    const uint64_t* old = old_grid + ((size_t)i * stride);
+    const uint64_t* then = saved_grid ? saved_grid + ((size_t)i * stride) : nullptr;
+    const uint64_t* before = older_grid ? older_grid + ((size_t)i * stride) : nullptr;
+    uint64_t* out = out_grid + ((size_t)i * stride);
+
+    for(unsigned j = 1; j <= cols; ++j){
+      uint64_t o = conway ? lifeRule(above[j - 1], above[j], above[j + 1],
+                                     row[j - 1], row[j], row[j + 1],
+                                     below[j - 1], below[j], below[j + 1]) :
+                            bsRule(above[j - 1], above[j], above[j + 1],
+                                   row[j - 1], row[j], row[j + 1],
+                                   below[j - 1], below[j], below[j + 1],
+                                   birth, survive, counts);
+      o = (o & ~frozen) | (row[j] & frozen);
+      out[j] = o;
+      any_alive |= o;
+      changed |= o ^ row[j];
+      changed2 |= o ^ old[j];
+      if(then)
+        changed_saved |= o ^ then[j];
+      if(before)
+        changed_older |= o ^ before[j];
+    }
+  }
+
+  // generation is already the one just computed
+  uint64_t empty = ~any_alive & want_empty[group] & ~frozen;
+  uint64_t stable = ~changed & want_stable[group] & ~frozen & ~empty;
+  uint64_t period2 = (generation >= 2) ?
+                     ~changed2 & want_period2[group] & ~frozen & ~empty & ~stable : 0;
+  uint64_t repeat_saved = saved_grid ? ~changed_saved : 0;
+  uint64_t repeat_older = older_grid ? ~changed_older & ~repeat_saved : 0;
+  uint64_t period = (repeat_saved | repeat_older) & want_period[group] &
+                    ~frozen & ~empty & ~stable & ~period2;
+  uint64_t limit = 0;
+  for(uint64_t running = ~frozen; running != 0; running &= running - 1){
+    unsigned b = __builtin_ctzll(running);
+    unsigned long long board_max = max_gens[lane_board[(group * 64) + b]];
+    if(board_max != 0 && generation >= board_max)
+      limit |= 1ULL << b;
+  }
+  limit &= ~empty & ~stable & ~period2 & ~period;
+
+  uint64_t halts = empty | stable | period2 | period | limit;
+  while(halts != 0){
+    unsigned b = __builtin_ctzll(halts);
+    uint64_t bit = 1ULL << b;
+    unsigned board = lane_board[(group * 64) + b];
+
+    halt_gen[board] = generation;
+    halt_reason[board] = (empty & bit) ? ehEmpty : (stable & bit) ? ehStable :
+                         (period2 & bit) ? ehPeriod2 : (period & bit) ? ehPeriod : ehLimit;
+    halt_period[board] = (stable & bit) ? 1 : (period2 & bit) ? 2 :
+                         (repeat_saved & period & bit) ? generation - saved_gen :
+                         (period & bit) ? generation - older_gen : 0;
+    halts &= halts - 1;
+  }
+  halted[group] |= empty | stable | period2 | period | limit;
+}
+
+unsigned LifeEnsemble::countRunning() const{
+  unsigned running = 0;
+  for(unsigned g = 0; g < num_groups; ++g)
+    running += __builtin_popcountll(~halted[g]);
+  return running;
+}
+
+bool LifeEnsemble::wantsPeriod() const{
+  for(unsigned g = 0; g < num_groups; ++g){
+    if(want_period[g] & ~halted[g])
+      return true;
+  }
+  return false;
+}
+
+// Moves every halted board out to the retired store and packs the
+// running ones into the first lanes, previous and saved generations
+// included so the period checks still work
+void LifeEnsemble::compact(){
+  unsigned running = countRunning();
+  unsigned new_groups = (running + 63) / 64;
+  std::vector<uint64_t> new_prev(new_groups * group_words, 0);
+  std::vector<uint64_t> new_curr(new_groups * group_words, 0);
+  std::vector<uint64_t> new_saved(saved.empty() ? 0 : new_groups * group_words, 0);
+  std::vector<uint64_t> new_older(older.empty() ? 0 : new_groups * group_words, 0);
+  std::vector<unsigned> new_lane_board(new_groups * 64, NO_BOARD);
+
+  if(retired.empty())
+    retired.assign(num_boards * board_words, 0);
+
+  unsigned new_lane = 0;
+  for(unsigned lane = 0; lane < num_groups * 64; ++lane){
+    unsigned board = lane_board[lane];
+    if(board == NO_BOARD)
+      continue;
+
+    uint64_t bit = 1ULL << (lane % 64);
+    bool keep = !(halted[lane / 64] & bit);
+    uint64_t new_bit = 1ULL << (new_lane % 64);
+
+    for(unsigned i = 0; i < rows; ++i){
+      for(unsigned j = 0; j < cols; ++j){
+        size_t from = cellIndex(lane, i, j);
+        if(keep){
+          size_t to = cellIndex(new_lane, i, j);
+          if(curr[from] & bit) new_curr[to] |= new_bit;
+          if(prev[from] & bit) new_prev[to] |= new_bit;
+          if(!saved.empty() && (saved[from] & bit)) new_saved[to] |= new_bit;
+          if(!older.empty() && (older[from] & bit)) new_older[to] |= new_bit;
+        }
+        else if(curr[from] & bit){
+          size_t index = ((size_t)i * cols) + j;
+          retired[(board * board_words) + (index / 64)] |= 1ULL << (index % 64);
+        }
+      }
+    }
+
+    if(keep){
+      new_lane_board[new_lane] = board;
+      board_lane[board] = new_lane++;
+    }
+    else
+      board_lane[board] = NO_BOARD;
+  }
+
+  num_groups = new_groups;
+  prev.swap(new_prev);
+  curr.swap(new_curr);
+  saved.swap(new_saved);
+  older.swap(new_older);
+  next.assign(num_groups * group_words, 0);
+  lane_board.swap(new_lane_board);
+
+  halted.assign(num_groups, 0);
+  if(running % 64 != 0)
+    halted[num_groups - 1] = ~0ULL << (running % 64);
+  want_empty.assign(num_groups, 0);
+  want_stable.assign(num_groups, 0);
+  want_period2.assign(num_groups, 0);
+  want_period.assign(num_groups, 0);
+  lane_birth.assign(num_groups * 9, 0);
+  lane_survive.assign(num_groups * 9, 0);
+  group_counts.assign(num_groups, 0);
+  group_conway.assign(num_groups, 0);
+  for(unsigned lane = 0; lane < num_groups * 64; ++lane){
+    unsigned board = lane_board[lane];
+    setLaneRule(lane, board == NO_BOARD ? conwayRule() : rules[board]);
+    if(board != NO_BOARD)
+      setHalt(board, conditions[board], max_gens[board]);
+  }
+}
+
+unsigned LifeEnsemble::step(WorkerPool* pool){
+  ++generation;
+
+  if(pool != nullptr && pool->getNumThreads() > 1 && num_groups > 1){
+    unsigned num_tasks = std::min(num_groups, pool->getNumThreads() * 4);
+    pool->run(num_tasks, [&](unsigned t){
+      unsigned last = (unsigned long long)(t + 1) * num_groups / num_tasks;
+      for(unsigned g = (unsigned long long)t * num_groups / num_tasks; g < last; ++g)
+        stepGroup(g);
+    });
+  }
+  else{
+    for(unsigned g = 0; g < num_groups; ++g)
+      stepGroup(g);
+  }
+
+  // prev <- curr <- next, and the oldest buffer is reused for the next step
+  std::swap(prev, curr);
+  std::swap(curr, next);
+
+  // a state is kept at generations 1, 2, 3, 4, 6, 8, 12... along with
+  // the one before it, and a board that comes back to either has found
+  // its period: once a kept state is on the cycle its first repeat is
+  // exactly one period later, and the gaps grow until they're longer
+  // than the period
+  unsigned long long odd_part = generation >> __builtin_ctzll(generation);
+  if((odd_part == 1 || odd_part == 3) && wantsPeriod()){
+    older.swap(saved);
+    older_gen = saved_gen;
+    saved = curr;
+    saved_gen = generation;
+  }
+
+  unsigned running = countRunning();
+  if(num_groups > 1 && running <= num_groups * 32)
+    compact();
+  return running;
+}
+
+unsigned long long LifeEnsemble::run(unsigned long long max_steps, WorkerPool* pool){
+  unsigned running = countRunning();
+  unsigned long long steps = 0;
+
+  while(running > 0 && steps < max_steps){
+    running = step(pool);
+    ++steps;
+  }
+  return steps;
+}
+
+// Steps a single board the ordinary way until it meets the same halt
+// conditions, returns the generation it halted at and sets the reason
+static unsigned long long runAlone(LifeBoard& board, unsigned conditions,
+                                   unsigned long long max_gens, EnsembleHalt* reason){
+  size_t words = (size_t)board.getRows() * board.getRowWords();
+  std::vector<uint64_t> last(words), before_last(words);
+
+  for(unsigned long long gen = 1; ; ++gen){
+    std::copy(board.getRow(0), board.getRow(0) + words, last.begin());
+    board.step();
+
+    const uint64_t* now = board.getRow(0);
+    bool empty = board.population() == 0;
+    bool stable = std::equal(now, now + words, last.begin());
+    bool period2 = gen >= 2 && std::equal(now, now + words, before_last.begin());
+
+    if((conditions & ehEmpty) && empty)
+      *reason = ehEmpty;
+    else if((conditions & ehStable) && stable)
+      *reason = ehStable;
+    else if((conditions & ehPeriod2) && period2)
+      *reason = ehPeriod2;
+    else if(max_gens != 0 && gen >= max_gens)
+      *reason = ehLimit;
+    else{
+      before_last.swap(last);
+      continue;
+    }
+    return gen;
+  }
+}
+
+static void printUsage(const char* prog){
+  std::cerr << "usage: " << prog << " ensemble [options]\n"
+            << "  --boards <n>                 boards to run (default 10000)\n"
+            << "  --rows <n>                   rows of each board (default 16)\n"
+            << "  --cols <n>                   columns of each board (default 16)\n"
+            << "  --gens <n>                   generation limit of each board (default 1000)\n"
+            << "  --seed <n>                   seed the boards are drawn from (default 1)\n"
+            << "  --threads <n>                stepping threads (default: all cores)\n"
+            << "  --compare <n>                boards to also step one at a time (default 1000)\n";
+}
+
+int runEnsemble(int argc, char* argv[]){
+  unsigned long long num_boards = 10000, rows = 16, cols = 16, gens = 1000;
+  unsigned long long seed = 1, compare = 1000;
+  unsigned threads = std::thread::hardware_concurrency();
+
+  for(int i = 2; i < argc; ++i){
+    std::string opt = argv[i];
+
+    if(i + 1 >= argc){
+      std::cerr << "Missing value for " << opt << std::endl;
+      printUsage(argv[0]);
+      return 1;
+    }
+    std::string val = argv[++i];
+
+    if(opt == "--boards")
+      num_boards = parseCount(opt, val);
+    else if(opt == "--rows")
+      rows = parseCount(opt, val);
+    else if(opt == "--cols")
+      cols = parseCount(opt, val);
+    else if(opt == "--gens")
+      gens = parseCount(opt, val);
+    else if(opt == "--seed")
+      seed = parseCount(opt, val);
+    else if(opt == "--threads")
+      threads = parseCount(opt, val);
+    else if(opt == "--compare")
+      compare = parseCount(opt, val);
+    else{
+      std::cerr << "Unknown option " << opt << std::endl;
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  if(threads == 0)
+    threads = 1;
+  if(compare > num_boards)
+    compare = num_boards;
+
+  unsigned conditions = ehEmpty | ehStable | ehPeriod2;
+  WorkerPool pool(threads);
+  LifeEnsemble ensemble(num_boards, rows, cols);
+  ensemble.randomize(seed);
+  ensemble.setHaltAll(conditions, gens);
+
+  std::vector<LifeBoard> starts(compare);
+  for(unsigned b = 0; b < compare; ++b)
+    ensemble.storeBoard(b, starts[b]);
+
+  Timer run_timer;
+  run_timer.Start();
+  unsigned long long steps = ensemble.run(gens, &pool);
+  double elapsed = run_timer.GetDuration();
+
+  unsigned long long board_gens = 0;
+  unsigned long long reasons[5] = {0, 0, 0, 0, 0};
+  for(unsigned b = 0; b < num_boards; ++b){
+    board_gens += ensemble.getHaltGeneration(b);
+    ++reasons[ensemble.getHaltReason(b)];
+  }
+
+  // the same boards one at a time, for comparison
+  unsigned long long alone_gens = 0, mismatches = 0;
+  double alone_elapsed = 0;
+  LifeBoard halted_board;
+  Timer alone_timer;
+
+  for(unsigned b = 0; b < compare; ++b){
+    EnsembleHalt reason;
+    alone_timer.Start();
+    unsigned long long halt_gen = runAlone(starts[b], conditions, gens, &reason);
+    alone_elapsed += alone_timer.GetDuration();
+    alone_gens += halt_gen;
+
+    bool same = (reason == ensemble.getHaltReason(b) && halt_gen == ensemble.getHaltGeneration(b));
+    ensemble.storeBoard(b, halted_board);
+    for(unsigned i = 0; i < rows; ++i){
+      same = same && std::equal(halted_board.getRow(i), halted_board.getRow(i) + halted_board.getUsedWords(),
+                                starts[b].getRow(i));
+    }
+    mismatches += !same;
+  }
+
+  std::cout << "boards:       " << num_boards << " of " << rows << "x" << cols << "\n"
+            << "threads:      " << pool.getNumThreads() << "\n"
+            << "steps:        " << steps << "\n"
+            << "board gens:   " << board_gens << "\n"
+            << "halted:       " << reasons[ehEmpty] << " empty, " << reasons[ehStable] << " stable, "
+            << reasons[ehPeriod2] << " period 2, " << reasons[ehLimit] << " at the limit\n"
+            << "elapsed:      " << elapsed << " s\n";
+
+  if(elapsed > 0)
+    std::cout << "board gens/s: " << board_gens / elapsed << "\n";
+
+  if(compare > 0 && alone_elapsed > 0 && elapsed > 0){
+    std::cout << "alone:        " << alone_gens / alone_elapsed << " board gens/s over "
+              << compare << " boards, " << mismatches << " mismatched\n";
+  }
+
+  return 0;
+}
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef _LIFE_ENSEMBLE_H
+#define _LIFE_ENSEMBLE_H
+
+#include <cstdint>
+#include <vector>
+#include "BSRule.h"
+#include "LifeBoard.h"
+#include "private/WorkerPool.h"
+
+// Lane of a board that's been moved out, or board of an empty lane
+#define NO_BOARD 0xFFFFFFFFu
+
+// Conditions a board can stop on, checked after every step
+enum EnsembleHalt{
+  ehLimit = 0,        // reached its generation limit
+  ehEmpty = 1,        // every cell died
+  ehStable = 2,       // the step changed nothing
+  ehPeriod2 = 4,      // back to how it was two generations ago
+  ehPeriod = 8        // back to how it was any number of generations ago
+};
+
+// Many small boards of the same size stepped together. Every board
+// has a lane: bit lane % 64 of lane group lane / 64, so each word of a
+// group holds one cell of 64 boards and a single pass of the bit-sliced
+// rule steps all of them. Each board stops on its own halt conditions
+// and keeps the state it halted in. Once at most half the lanes are
+// still running, the halted boards are moved out and the running ones
+// packed into fewer groups, so stragglers don't keep every group busy.
+// Boards run B3/S23 unless given another rule. A group whose boards
+// all run B3/S23 takes the fixed rule, any other only looks at the
+// neighbor counts some board of the group's rule uses, so boards whose
+// rules use the same counts are best kept next to each other.
+class LifeEnsemble {
+  private:
+    unsigned num_boards;
+    unsigned num_groups;
+    unsigned rows;
+    unsigned cols;
+    unsigned stride;        // cols plus a halo column each side
+    size_t group_words;     // (rows + 2) * stride
+    size_t board_words;     // rows * cols bits, for a retired board
+    BoundaryScheme bound_scheme;
+    unsigned long long generation;
+
+    std::vector<uint64_t> prev, curr, next;
+    std::vector<uint64_t> saved, older;           // states at saved_gen and older_gen, for ehPeriod
+    unsigned long long saved_gen, older_gen;
+    std::vector<uint64_t> halted;                 // per group
+    std::vector<uint64_t> want_empty, want_stable, want_period2, want_period;
+    std::vector<uint64_t> lane_birth, lane_survive;   // 9 per group, a lane mask per count
+    std::vector<uint16_t> group_counts;           // per group, counts its rules use
+    std::vector<uint8_t> group_conway;            // per group, every lane runs B3/S23
+    std::vector<unsigned> lane_board;             // per lane, or NO_BOARD
+    std::vector<unsigned> board_lane;             // per board, or NO_BOARD once retired
+    std::vector<uint64_t> retired;                // board_words per board
+    std::vector<uint8_t> conditions;              // per board
+    std::vector<unsigned long long> max_gens;     // per board, 0 for none
+    std::vector<unsigned long long> halt_gen;     // per board
+    std::vector<unsigned long long> halt_period;  // per board
+    std::vector<BSRule> rules;                    // per board
+    std::vector<uint8_t> halt_reason;             // per board
+
+    size_t cellIndex(unsigned lane, unsigned row, unsigned col) const;
+    void fillHalo(uint64_t* grid) const;
+    void setLaneRule(unsigned lane, BSRule rule);
+    void stepGroup(unsigned group);
+    unsigned countRunning() const;
+    bool wantsPeriod() const;
+    void compact();
+
+  public:
+    LifeEnsemble(unsigned _num_boards, unsigned _rows, unsigned _cols,
+                 BoundaryScheme scheme = Flat);
+
+    unsigned getNumBoards() const;
+    unsigned getRows() const;
+    unsigned getCols() const;
+    unsigned long long getGeneration() const;
+
+    // Edits go to the board as it is now, a halted board stays halted
+    bool getCell(unsigned board, unsigned row, unsigned col) const;
+    void setCell(unsigned board, unsigned row, unsigned col, bool alive);
+
+    // Copies a board of the same size in or out
+    void loadBoard(unsigned board, const LifeBoard& source);
+    void storeBoard(unsigned board, LifeBoard& dest) const;
+
+    // Copies the same board into every running board
+    void loadBoardAll(const LifeBoard& source);
+
+    // Fills every running board with random cells at 50% density
+    // from the seed
+    void randomize(unsigned long long seed);
+
+    // Sets what the board stops on, a mask of EnsembleHalt values, and
+    // the generation it stops at regardless (0 for no limit)
+    void setHalt(unsigned board, unsigned _conditions, unsigned long long _max_gens = 0);
+    void setHaltAll(unsigned _conditions, unsigned long long _max_gens = 0);
+
+    // Sets the rule the board steps under from now on
+    void setRule(unsigned board, BSRule rule);
+    BSRule getRule(unsigned board) const;
+
+    bool isHalted(unsigned board) const;
+    unsigned long long getHaltGeneration(unsigned board) const;
+    EnsembleHalt getHaltReason(unsigned board) const;
+
+    // Period the board halted in: 1 when stable, 2 for ehPeriod2, the
+    // generations back to its last repeat for ehPeriod, else 0
+    unsigned long long getHaltPeriod(unsigned board) const;
+    unsigned long long population(unsigned board) const;
+
+    // Steps every board that's still running, splitting the groups
+    // across the pool, and returns how many are left running
+    unsigned step(WorkerPool* pool = nullptr);
+
+    // Steps until every board has halted or max_steps steps have been
+    // taken, returns the number of steps
+    unsigned long long run(unsigned long long max_steps, WorkerPool* pool = nullptr);
+};
+
+// "ensemble" followed by its options steps random boards as an
+// ensemble and then one at a time, and compares the two. Returns the
+// exit code.
+int runEnsemble(int argc, char* argv[]);
+
+#endif
@@ -0,0 +1,132 @@
+/*
+ *  Author: Abraham Cardenas / https://github.com/Abe-Crdns
+ */
+
+#ifndef _LIGHT_CONE_CPP
+#define _LIGHT_CONE_CPP
+
+#include <algorithm>
+#include "../lpc_lib/lpclib.h"
+#include "LightCone.h"
+
+// The rows or columns of the board a cone covers. On a donut the
+// start can be off the board, and a cone as big as the board covers
+// all of it and keeps wrapping.
+struct ConeSpan {
+  long long start;
+  unsigned size;
+  bool whole;
+};
+
+static ConeSpan coneSpan(unsigned first, unsigned length, unsigned dim,
+                         unsigned long long margin, bool wrap){
+  // anything further out is off the board either way
+  margin = std::min<unsigned long long>(margin, dim);
+
+  ConeSpan span;
+  if(wrap){
+    span.whole = (length + (2 * margin) >= dim);
+    span.start = span.whole ? 0 : (long long)first - (long long)margin;
+    span.size = span.whole ? dim : length + (2 * margin);
+  }
+  else{
+    long long start = std::max<long long>(0, (long long)first - (long long)margin);
+    long long end = std::min<long long>(dim, (long long)first + length + margin);
+    span.whole = (start == 0 && end == dim);
+    span.start = start;
+    span.size = end - start;
+  }
+  return span;
+}
+
+// Where the destination span starts in the source. A whole span on a
+// donut wraps, so the part past its end is stamped from its start.
+static int spanOffset(const ConeSpan& from, const ConeSpan& to, unsigned dim, bool wrap){
+  long long offset = to.start - from.start;
+  if(wrap && from.whole)
+    offset = ((offset % dim) + dim) % dim;
+  return (int)offset;
+}
+
+// Copies the part of the cone in src that the new spans cover into dest
+static void cutCone(const LifeBoard& src, const ConeSpan& src_rows, const ConeSpan& src_cols,
+                    const ConeSpan& rows, const ConeSpan& cols,
+                    unsigned board_rows, unsigned board_cols, bool wrap, LifeBoard& dest){
+  int row_offset = spanOffset(src_rows, rows, board_rows, wrap);
+  int col_offset = spanOffset(src_cols, cols, board_cols, wrap);
+
+  dest.setBoundScheme(src.getBoundScheme());
+  if(dest.getRows() != rows.size || dest.getCols() != cols.size)
+    dest.resize(rows.size, cols.size);
+  else
+    dest.clear();
+
+  bool row_wrap = wrap && src_rows.whole && (unsigned)row_offset + rows.size > board_rows;
+  bool col_wrap = wrap && src_cols.whole && (unsigned)col_offset + cols.size > board_cols;
+
+  dest.stamp(src, -row_offset, -col_offset);
+  if(row_wrap)
+    dest.stamp(src, (int)board_rows - row_offset, -col_offset);
+  if(col_wrap)
+    dest.stamp(src, -row_offset, (int)board_cols - col_offset);
+  if(row_wrap && col_wrap)
+    dest.stamp(src, (int)board_rows - row_offset, (int)board_cols - col_offset);
+
+  dest.setGeneration(src.getGeneration());
+}
+
+void stepWindow(const LifeBoard& board, const ConeWindow& window, unsigned long long gens,
+                LifeBoard& result, WorkerPool* pool, ConeStats* stats){
+  unsigned board_rows = board.getRows(), board_cols = board.getCols();
+  bool wrap = (board.getBoundScheme() == Donut);
+
+  if(window.rows == 0 || window.cols == 0 ||
+     window.top + window.rows > board_rows || window.left + window.cols > board_cols)
+    Error("The window doesn't fit on the board");
+
+  if(stats != nullptr){
+    stats->cells_stepped = 0;
+    stats->board_cells = (unsigned long long)board_rows * board_cols * gens;
+    stats->cuts = 0;
+  }
+
+  // the cone is cut back and forth between two boards
+  LifeBoard cones[2];
+  const LifeBoard* cone = &board;
+  ConeSpan cone_rows = coneSpan(0, board_rows, board_rows, 0, wrap);
+  ConeSpan cone_cols = coneSpan(0, board_cols, board_cols, 0, wrap);
+  unsigned next_cone = 0;
+  unsigned long long remaining = gens;
+
+  while(remaining > 0){
+    ConeSpan rows = coneSpan(window.top, window.rows, board_rows, remaining, wrap);
+    ConeSpan cols = coneSpan(window.left, window.cols, board_cols, remaining, wrap);
+
+    if(cone == &board || rows.size != cone_rows.size || cols.size != cone_cols.size){
+      LifeBoard& dest = cones[next_cone];
+      cutCone(*cone, cone_rows, cone_cols, rows, cols, board_rows, board_cols, wrap, dest);
+      cone = &dest;
+      cone_rows = rows;
+      cone_cols = cols;
+      next_cone ^= 1;
+      if(stats != nullptr)
+        ++stats->cuts;
+    }
+
+    LifeBoard& stepping = cones[next_cone ^ 1];
+    unsigned long long steps = std::min<unsigned long long>(remaining, CONE_CUT_GENS);
+    for(unsigned long long g = 0; g < steps; ++g)
+      stepping.step(pool);
+    remaining -= steps;
+
+    if(stats != nullptr)
+      stats->cells_stepped += (unsigned long long)rows.size * cols.size * steps;
+  }
+
+  ConeSpan rows = coneSpan(window.top, window.rows, board_rows, 0, wrap);
+  ConeSpan cols = coneSpan(window.left, window.cols, board_cols, 0, wrap);
+  cutCone(*cone, cone_rows, cone_cols, rows, cols, board_rows, board_cols, wrap, result);
+  result.setBoundScheme(Flat);
+}
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef _LIGHT_CONE_H
+#define _LIGHT_CONE_H
+
+#include "LifeBoard.h"
+#include "private/WorkerPool.h"
+
+// Generations stepped between cutting the cone down
+#define CONE_CUT_GENS 32
+
+// A rectangle of the board, in cells
+struct ConeWindow {
+  unsigned top, left;
+  unsigned rows, cols;
+};
+
+// Work a window query did next to what stepping the board would have
+struct ConeStats {
+  unsigned long long cells_stepped;   // summed over every generation
+  unsigned long long board_cells;     // the whole board over as many
+  unsigned cuts;                      // times the cone was cut down
+};
+
+// Fills result with the window as it'll be gens generations on,
+// stepping only the window's light cone. Nothing moves faster than a
+// cell a generation, so with m generations to go only the cells within
+// m of the window can still reach it: the cone starts as the window
+// grown by gens on every side, clipped to the board or wrapped on a
+// donut, and is cut down to the shrinking margin every CONE_CUT_GENS
+// generations. Whatever goes wrong at the cut edges never reaches the
+// window in time. The board isn't changed.
+void stepWindow(const LifeBoard& board, const ConeWindow& window, unsigned long long gens,
+                LifeBoard& result, WorkerPool* pool = nullptr, ConeStats* stats = nullptr);
+
+#endif
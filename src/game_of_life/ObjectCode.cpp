@@ -0,0 +1,173 @@
+/*
+ *  Author: Abraham Cardenas / https://github.com/Abe-Crdns
+ */
+
+#ifndef _OBJECT_CODE_CPP
+#define _OBJECT_CODE_CPP
+
+#include <algorithm>
+#include <sstream>
+#include "ObjectCode.h"
+
+static const char WECHSLER_DIGITS[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+void normalizeCells(CellList& cells){
+  if(cells.empty())
+    return;
+
+  int top = cells[0].first, left = cells[0].second;
+  for(size_t i = 1; i < cells.size(); ++i){
+    top = std::min(top, cells[i].first);
+    left = std::min(left, cells[i].second);
+  }
+
+  for(size_t i = 0; i < cells.size(); ++i){
+    cells[i].first -= top;
+    cells[i].second -= left;
+  }
+  std::sort(cells.begin(), cells.end());
+}
+
+CellList boardCells(const LifeBoard& board){
+  CellList cells;
+  for(unsigned i = 0; i < board.getRows(); ++i){
+    for(unsigned j = board.nextCell(i, 0); j < board.getCols(); j = board.nextCell(i, j + 1))
+      cells.push_back(std::make_pair((int)i, (int)j));
+  }
+  return cells;
+}
+
+bool findPeriod(const CellList& cells, unsigned max_period, unsigned* period,
+                int* drow, int* dcol, std::vector<CellList>* phases){
+  if(cells.empty())
+    return false;
+
+  CellList start = cells;
+  normalizeCells(start);
+
+  int height = 0, width = 0;
+  for(size_t i = 0; i < start.size(); ++i){
+    height = std::max(height, start[i].first + 1);
+    width = std::max(width, start[i].second + 1);
+  }
+
+  // nothing moves faster than a cell a generation, so it never
+  // reaches the edge
+  int margin = max_period + 2;
+  LifeBoard board(height + (2 * margin), width + (2 * margin));
+  for(size_t i = 0; i < start.size(); ++i)
+    board.setCell(start[i].first + margin, start[i].second + margin, true);
+
+  phases->clear();
+  phases->push_back(start);
+
+  for(unsigned gen = 1; gen <= max_period; ++gen){
+    board.step();
+
+    CellList now = boardCells(board);
+    if(now.empty())
+      return false;
+
+    int top = now[0].first, left = now[0].second;
+    for(size_t i = 1; i < now.size(); ++i)
+      left = std::min(left, now[i].second);
+    normalizeCells(now);
+
+    if(now == start){
+      *period = gen;
+      *drow = top - margin;
+      *dcol = left - margin;
+      return true;
+    }
+    phases->push_back(now);
+  }
+
+  return false;
+}
+
+// Appends a run of blank columns
+static void appendBlanks(std::string& code, unsigned blanks){
+  while(blanks >= 4){
+    unsigned run = std::min(blanks, 39u);
+    code += 'y';
+    code += WECHSLER_DIGITS[run - 4];
+    blanks -= run;
+  }
+  if(blanks == 3)
+    code += 'x';
+  else if(blanks == 2)
+    code += 'w';
+  else if(blanks == 1)
+    code += '0';
+}
+
+std::string wechsler(const CellList& cells){
+  int height = 0, width = 0;
+  for(size_t i = 0; i < cells.size(); ++i){
+    height = std::max(height, cells[i].first + 1);
+    width = std::max(width, cells[i].second + 1);
+  }
+
+  std::string code;
+  std::vector<unsigned> columns(width);
+  size_t next = 0;
+
+  for(int strip = 0; strip * 5 < height; ++strip){
+    std::fill(columns.begin(), columns.end(), 0);
+    for(; next < cells.size() && cells[next].first < (strip + 1) * 5; ++next)
+      columns[cells[next].second] |= 1 << (cells[next].first - (strip * 5));
+
+    if(strip > 0)
+      code += 'z';
+
+    // blanks at the end of a strip are left off
+    unsigned blanks = 0;
+    for(int j = 0; j < width; ++j){
+      if(columns[j] == 0){
+        ++blanks;
+        continue;
+      }
+      appendBlanks(code, blanks);
+      blanks = 0;
+      code += WECHSLER_DIGITS[columns[j]];
+    }
+  }
+
+  return code;
+}
+
+std::string objectCode(const std::vector<CellList>& phases, bool moving){
+  std::string best;
+
+  for(size_t p = 0; p < phases.size(); ++p){
+    for(unsigned orient = 0; orient < 8; ++orient){
+      CellList turned = phases[p];
+      for(size_t i = 0; i < turned.size(); ++i){
+        int row = turned[i].first, col = turned[i].second;
+        if(orient & 4)
+          std::swap(row, col);
+        turned[i].first = (orient & 1) ? -row : row;
+        turned[i].second = (orient & 2) ? -col : col;
+      }
+      normalizeCells(turned);
+
+      std::string code = wechsler(turned);
+      if(best.empty() || code.size() < best.size() ||
+         (code.size() == best.size() && code < best))
+        best = code;
+    }
+  }
+
+  std::ostringstream name;
+  if(moving)
+    name << "xq" << phases.size();
+  else if(phases.size() == 1)
+    name << "xs" << phases[0].size();
+  else
+    name << "xp" << phases.size();
+  name << "_" << best;
+
+  return name.str();
+}
+
+#endif
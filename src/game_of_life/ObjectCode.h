@@ -0,0 +1,39 @@
+#ifndef _OBJECT_CODE_H
+#define _OBJECT_CODE_H
+
+#include <string>
+#include <utility>
+#include <vector>
+#include "LifeBoard.h"
+
+// Live cells of an object as (row, col) pairs
+typedef std::vector<std::pair<int, int> > CellList;
+
+// Shifts the cells so the smallest row and column are 0, sorted
+// row by row
+void normalizeCells(CellList& cells);
+
+// Live cells of the board, row by row
+CellList boardCells(const LifeBoard& board);
+
+// Runs the cells on their own for up to max_period generations. If
+// they come back to the same shape, sets the period, how far the
+// shape moved (0, 0 for anything but a spaceship) and every phase,
+// normalized, and returns true.
+bool findPeriod(const CellList& cells, unsigned max_period, unsigned* period,
+                int* drow, int* dcol, std::vector<CellList>* phases);
+
+// Extended Wechsler format of normalized cells: strips of 5 rows
+// separated by 'z', one base-32 digit per column with w, x and y
+// standing for runs of blank columns
+std::string wechsler(const CellList& cells);
+
+// Name of an object the way apgsearch writes it, such as xs4_33 for a
+// block or xq4_153 for a glider: xs<population> for a still life,
+// xp<period> for an oscillator or xq<period> for a spaceship, then the
+// shortest and (among those) smallest Wechsler code over every phase
+// and all 8 orientations. The same object always gets the same name,
+// wherever it is and however it's turned.
+std::string objectCode(const std::vector<CellList>& phases, bool moving);
+
+#endif
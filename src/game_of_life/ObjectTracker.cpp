@@ -0,0 +1,178 @@
+/*
+ *  Author: Abraham Cardenas / https://github.com/Abe-Crdns
+ */
+
+#ifndef _OBJECT_TRACKER_CPP
+#define _OBJECT_TRACKER_CPP
+
+#include <algorithm>
+#include <numeric>
+#include "ObjectTracker.h"
+#include "private/SplitMix.h"
+
+// Objects classified by a task at a time
+static const size_t OBJECTS_PER_TASK = 4096;
+
+// A shape at a particular place
+static inline uint64_t placedKey(uint64_t shape, unsigned top, unsigned left){
+  uint64_t state = shape ^ (((uint64_t)top << 32) | left);
+  return splitMix64(&state);
+}
+
+ObjectTracker::ObjectTracker(unsigned _max_period){
+  max_period = std::max(_max_period, 1u);
+  reset();
+}
+
+void ObjectTracker::reset(){
+  objects.clear();
+  past.clear();
+  counts.still = counts.oscillators = counts.spaceships = counts.unknown = 0;
+}
+
+// Rolls each run into its object's shape, row by row, relative to the
+// object's top left corner
+void ObjectTracker::hashShapes(unsigned rows){
+  const std::vector<BoardObject>& found = labeler.getObjects();
+  objects.resize(found.size());
+
+  for(size_t k = 0; k < found.size(); ++k){
+    objects[k].bounds = found[k];
+    objects[k].shape = found[k].population;
+  }
+
+  for(unsigned i = 0; i < rows; ++i){
+    for(uint32_t r = labeler.firstRun(i); r < labeler.firstRun(i + 1); ++r){
+      unsigned start, end, object;
+      labeler.getRun(r, &start, &end, &object);
+
+      TrackedObject& tracked = objects[object];
+      uint64_t run = ((uint64_t)(i - tracked.bounds.top) << 42) |
+                     ((uint64_t)(start - tracked.bounds.left) << 21) |
+                     (end - tracked.bounds.left);
+      tracked.shape = (tracked.shape ^ run) * 0x100000001B3ULL;
+      tracked.shape ^= tracked.shape >> 29;
+    }
+  }
+}
+
+// Looks for the object's shape in each earlier generation, nearest
+// first: in the same place, then anywhere a spaceship could have been
+void ObjectTracker::classify(TrackedObject& object) const{
+  unsigned top = object.bounds.top, left = object.bounds.left;
+  uint64_t key = placedKey(object.shape, top, left);
+
+  object.kind = okUnknown;
+  object.period = 0;
+  object.drow = object.dcol = 0;
+
+  for(unsigned p = 1; p <= past.size(); ++p){
+    if(past[p - 1].placed.count(key)){
+      object.kind = (p == 1) ? okStill : okOscillator;
+      object.period = p;
+      return;
+    }
+  }
+
+  // nothing goes faster than c/2, a cell every other generation
+  for(unsigned p = 2; p <= past.size(); ++p){
+    auto range = past[p - 1].corners.equal_range(object.shape);
+    int best = -1;
+
+    for(auto it = range.first; it != range.second; ++it){
+      int drow = (int)top - (int)it->second.first;
+      int dcol = (int)left - (int)it->second.second;
+      int dist = std::max(abs(drow), abs(dcol));
+      if(dist == 0 || 2 * dist > (int)p || (best >= 0 && dist >= best))
+        continue;
+
+      best = dist;
+      object.kind = okSpaceship;
+      object.period = p;
+      object.drow = drow;
+      object.dcol = dcol;
+    }
+
+    if(object.kind == okSpaceship)
+      return;
+  }
+}
+
+void ObjectTracker::update(const LifeBoard& board, WorkerPool* pool){
+  labeler.label(board, pool);
+  hashShapes(board.getRows());
+
+  // classifying only reads the past, so objects split across the pool
+  size_t num_tasks = (objects.size() + OBJECTS_PER_TASK - 1) / OBJECTS_PER_TASK;
+  if(pool != nullptr && pool->getNumThreads() > 1 && num_tasks > 1){
+    pool->run(num_tasks, [&](unsigned t){
+      size_t last = std::min((t + 1) * OBJECTS_PER_TASK, objects.size());
+      for(size_t k = t * OBJECTS_PER_TASK; k < last; ++k)
+        classify(objects[k]);
+    });
+  }
+  else{
+    for(size_t k = 0; k < objects.size(); ++k)
+      classify(objects[k]);
+  }
+
+  counts.still = counts.oscillators = counts.spaceships = counts.unknown = 0;
+  if(past.size() == max_period){
+    past.push_front(std::move(past.back()));
+    past.pop_back();
+  }
+  else
+    past.push_front(ShapeTable());
+
+  ShapeTable& now = past.front();
+  now.placed.clear();
+  now.corners.clear();
+  now.placed.reserve(objects.size());
+  now.corners.reserve(objects.size());
+
+  for(size_t k = 0; k < objects.size(); ++k){
+    const TrackedObject& object = objects[k];
+    now.placed.insert(placedKey(object.shape, object.bounds.top, object.bounds.left));
+    now.corners.insert(std::make_pair(object.shape,
+                                      std::make_pair(object.bounds.top, object.bounds.left)));
+
+    switch(object.kind){
+      case okStill:       ++counts.still; break;
+      case okOscillator:  ++counts.oscillators; break;
+      case okSpaceship:   ++counts.spaceships; break;
+      default:            ++counts.unknown; break;
+    }
+  }
+}
+
+const std::vector<TrackedObject>& ObjectTracker::getObjects() const{
+  return objects;
+}
+
+const ObjectCounts& ObjectTracker::getCounts() const{
+  return counts;
+}
+
+std::string objectLabel(const TrackedObject& object){
+  switch(object.kind){
+    case okStill:
+      return "still";
+
+    case okOscillator:
+      return "p" + std::to_string(object.period);
+
+    case okSpaceship:{
+      // speed as a reduced fraction of c
+      unsigned dist = std::max(abs(object.drow), abs(object.dcol));
+      unsigned divisor = std::gcd(dist, object.period);
+      dist /= divisor;
+      std::string speed = (dist == 1) ? "" : std::to_string(dist);
+      return speed + "c/" + std::to_string(object.period / divisor);
+    }
+
+    default:
+      return "";
+  }
+}
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef _OBJECT_TRACKER_H
+#define _OBJECT_TRACKER_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "ComponentLabeler.h"
+#include "LifeBoard.h"
+#include "private/WorkerPool.h"
+
+// Generations of shapes kept by default, the longest period found
+#define TRACK_MAX_PERIOD 16
+
+enum ObjectKind{
+  okUnknown,        // nothing it matches yet
+  okStill,          // same shape in the same place a generation ago
+  okOscillator,     // same shape in the same place period generations ago
+  okSpaceship       // same shape, moved, period generations ago
+};
+
+struct TrackedObject {
+  BoardObject bounds;
+  uint64_t shape;       // hash of the cells relative to the bounds
+  ObjectKind kind;
+  unsigned period;
+  int drow, dcol;       // moved per period, a spaceship's only
+};
+
+struct ObjectCounts {
+  unsigned long long still;
+  unsigned long long oscillators;
+  unsigned long long spaceships;
+  unsigned long long unknown;
+};
+
+// Classifies each object of the board as it's stepped. Every update
+// labels the board's objects and hashes each one's runs of cells,
+// relative to its bounds, into a shape. An object whose shape was in
+// the same place p generations ago has period p; one whose shape was
+// somewhere else, no further than a spaceship can go in p generations,
+// is a spaceship. Only the last max_period generations of shapes are
+// kept, so memory stays bounded however long it runs.
+class ObjectTracker {
+  private:
+    // Shapes of one generation, by shape and place and by shape alone
+    struct ShapeTable {
+      std::unordered_set<uint64_t> placed;
+      std::unordered_multimap<uint64_t, std::pair<unsigned, unsigned> > corners;
+    };
+
+    unsigned max_period;
+    ComponentLabeler labeler;
+    std::vector<TrackedObject> objects;
+    std::deque<ShapeTable> past;      // newest first
+    ObjectCounts counts;
+
+    void hashShapes(unsigned rows);
+    void classify(TrackedObject& object) const;
+
+  public:
+    ObjectTracker(unsigned _max_period = TRACK_MAX_PERIOD);
+
+    // Forgets every generation seen, for after the board's been
+    // edited or stepped back
+    void reset();
+
+    // Classifies the board's objects, call once per generation
+    void update(const LifeBoard& board, WorkerPool* pool = nullptr);
+
+    const std::vector<TrackedObject>& getObjects() const;
+    const ObjectCounts& getCounts() const;
+};
+
+// Short label for an object: "still", "p2", "c/4" and so on, or an
+// empty string if it's unknown
+std::string objectLabel(const TrackedObject& object);
+
+#endif
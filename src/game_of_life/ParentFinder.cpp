@@ -0,0 +1,124 @@
+/*
+ *  Author: Abraham Cardenas / https://github.com/Abe-Crdns
+ */
+
+#ifndef _PARENT_FINDER_CPP
+#define _PARENT_FINDER_CPP
+
+#include "ParentFinder.h"
+#include "private/Timer.h"
+#include "private/WorkerPool.h"
+
+ParentFinder::ParentFinder(unsigned _threads){
+  threads = (_threads != 0) ? _threads : std::thread::hardware_concurrency();
+  if(threads == 0)
+    threads = 1;
+
+  edges = peFree;
+  max_nodes = 0;
+  requested = false;
+  active = false;
+  finished = false;
+  stopping = false;
+  epoch = 0;
+  searching = nullptr;
+  worker = std::thread(&ParentFinder::workerLoop, this);
+}
+
+ParentFinder::~ParentFinder(){
+  {
+    std::lock_guard<std::mutex> lock(finder_mutex);
+    stopping = true;
+    if(searching != nullptr)
+      searching->stop();
+  }
+  has_work.notify_one();
+  worker.join();
+}
+
+void ParentFinder::start(const LifeBoard& _target, int _edges, unsigned long long _max_nodes){
+  {
+    std::lock_guard<std::mutex> lock(finder_mutex);
+    if(searching != nullptr)
+      searching->stop();
+
+    target = _target;
+    edges = _edges;
+    max_nodes = _max_nodes;
+    requested = true;
+    active = true;
+    finished = false;
+    ++epoch;
+  }
+  has_work.notify_one();
+}
+
+void ParentFinder::cancel(){
+  std::lock_guard<std::mutex> lock(finder_mutex);
+  if(!active)
+    return;
+
+  if(searching != nullptr)
+    searching->stop();
+  requested = false;
+  active = false;
+  finished = false;
+  ++epoch;
+}
+
+bool ParentFinder::isActive(){
+  std::lock_guard<std::mutex> lock(finder_mutex);
+  return active;
+}
+
+bool ParentFinder::take(ParentResult& _result){
+  std::lock_guard<std::mutex> lock(finder_mutex);
+  if(!finished)
+    return false;
+
+  _result = result;
+  finished = false;
+  active = false;
+  return true;
+}
+
+// Searches outside the lock, and keeps the result only if nothing
+// started or cancelled a search meanwhile. The search is only ever
+// stopped under the lock, while searching points at it.
+void ParentFinder::workerLoop(){
+  std::unique_lock<std::mutex> lock(finder_mutex);
+
+  while(true){
+    has_work.wait(lock, [this]{ return stopping || requested; });
+    if(stopping)
+      return;
+
+    requested = false;
+    unsigned long long started = epoch;
+    int search_edges = edges;
+    unsigned long long search_max = max_nodes;
+    PredecessorSearch search(target, search_edges);
+    searching = &search;
+    lock.unlock();
+
+    WorkerPool pool(threads);
+    Timer search_timer;
+    search_timer.Start();
+    ParentOutcome outcome = search.search(&pool, search_max);
+    double elapsed = search_timer.GetDuration();
+
+    lock.lock();
+    searching = nullptr;
+    if(started == epoch){
+      result.outcome = outcome;
+      if(outcome == poFound)
+        result.parent = search.getParent();
+      result.edges = search_edges;
+      result.nodes = search.getNodes();
+      result.elapsed = elapsed;
+      finished = true;
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef _PARENT_FINDER_H
+#define _PARENT_FINDER_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "LifeBoard.h"
+#include "PredecessorSearch.h"
+
+// What a finished search came to
+struct ParentResult {
+  ParentOutcome outcome;
+  LifeBoard parent;       // if found, as PredecessorSearch::getParent
+  int edges;              // the search was started with
+  unsigned long long nodes;
+  double elapsed;         // seconds
+};
+
+// Runs a PredecessorSearch on a background thread, so the window keeps
+// handling input while it looks. Anything done to the board makes the
+// search pointless: cancel stops it without waiting on its threads,
+// and its result is never handed over.
+class ParentFinder {
+  private:
+    unsigned threads;
+    LifeBoard target;
+    int edges;
+    unsigned long long max_nodes;
+
+    bool requested;                 // a target is waiting for the worker
+    bool active;                    // started and not yet taken or cancelled
+    bool finished;                  // result is ready to take
+    bool stopping;
+    unsigned long long epoch;       // changes with every start and cancel
+    PredecessorSearch* searching;   // the worker's search, while it runs
+    ParentResult result;
+
+    std::mutex finder_mutex;
+    std::condition_variable has_work;
+    std::thread worker;
+
+    void workerLoop();
+
+  public:
+    // Searches on _threads threads, all cores if 0
+    ParentFinder(unsigned _threads = 0);
+    ~ParentFinder();
+
+    // Drops any search under way and looks for a parent of the target
+    void start(const LifeBoard& _target, int _edges, unsigned long long _max_nodes);
+    void cancel();
+
+    // Whether a search was started and its result hasn't been taken
+    bool isActive();
+
+    // Hands over the result once the search has finished. Returns
+    // false while it's still going or if none was started.
+    bool take(ParentResult& _result);
+};
+
+#endif
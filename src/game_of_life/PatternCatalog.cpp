@@ -0,0 +1,298 @@
+/*
+ *  Author: Abraham Cardenas / https://github.com/Abe-Crdns
+ */
+
+#ifndef _PATTERN_CATALOG_CPP
+#define _PATTERN_CATALOG_CPP
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../lpc_lib/lpclib.h"
+#include "PatternCatalog.h"
+#include "PatternFile.h"
+
+// The name lexicon only holds the letters a-z, so each byte of a
+// lowercased name becomes two letters, one per nibble. That keeps
+// prefixes prefixes and sorts the same way.
+static std::string lexiconKey(const std::string& lower_name){
+  std::string key;
+  key.reserve(2 * lower_name.size());
+  for(unsigned char c : lower_name){
+    key += (char)('a' + (c >> 4));
+    key += (char)('a' + (c & 0xF));
+  }
+  return key;
+}
+
+// Compares the first length characters of name, lowercased, with
+// lower_name, like strcmp. Only the first length characters of
+// lower_name are compared if prefix_only is set.
+static int compareLower(const char* name, size_t length, const std::string& lower_name,
+                        bool prefix_only = false){
+  size_t n = prefix_only ? lower_name.size() : std::max(length, lower_name.size());
+  for(size_t i = 0; i < n; ++i){
+    if(i >= length)
+      return -1;
+    if(i >= lower_name.size())
+      return 1;
+
+    unsigned char a = tolower((unsigned char)name[i]);
+    unsigned char b = lower_name[i];
+    if(a != b)
+      return a < b ? -1 : 1;
+  }
+  return 0;
+}
+
+static bool isCatalogFormat(const std::string& filename, std::string* name){
+  size_t dot = filename.find_last_of('.');
+  if(dot == std::string::npos || dot == 0)
+    return false;
+
+  std::string ext = ConvertToLowerCase(filename.substr(dot + 1));
+  if(ext != "rle" && ext != "cells" && ext != "txt" && ext != "mc")
+    return false;
+
+  *name = filename.substr(0, dot);
+  return true;
+}
+
+PatternCatalog::PatternCatalog(std::string _dir){
+  dir = _dir;
+  loaded = false;
+  map = nullptr;
+  map_size = 0;
+  header = nullptr;
+  entries = nullptr;
+  names = nullptr;
+}
+
+PatternCatalog::~PatternCatalog(){
+  if(map != nullptr)
+    munmap(map, map_size);
+}
+
+unsigned PatternCatalog::build(){
+  struct Source {
+    std::string lower_name;
+    std::string name;
+    std::string path;
+  };
+  std::vector<Source> sources;
+
+  DIR* dirp = opendir(dir.c_str());
+  if(dirp == nullptr)
+    Error("Couldn't open pattern catalog " + dir);
+
+  struct dirent* dent;
+  while((dent = readdir(dirp)) != nullptr){
+    Source source;
+    if(!isCatalogFormat(dent->d_name, &source.name))
+      continue;
+    source.lower_name = ConvertToLowerCase(source.name);
+    source.path = dir + "/" + dent->d_name;
+    sources.push_back(source);
+  }
+  closedir(dirp);
+
+  std::sort(sources.begin(), sources.end(),
+            [](const Source& a, const Source& b){ return a.lower_name < b.lower_name; });
+
+  CatalogHeader new_header;
+  memset(&new_header, 0, sizeof(new_header));
+  memcpy(new_header.magic, CATALOG_MAGIC, sizeof(CATALOG_MAGIC));
+  new_header.version = CATALOG_VERSION;
+  new_header.num_entries = sources.size();
+
+  std::vector<CatalogEntry> new_entries(sources.size());
+  std::string new_names;
+  std::vector<uint64_t> bits;
+  Lexicon lexicon;
+
+  for(size_t i = 0; i < sources.size(); ++i){
+    if(i > 0 && sources[i].lower_name == sources[i - 1].lower_name)
+      Error("Two patterns named " + sources[i].name + " in catalog " + dir);
+
+    CatalogEntry& entry = new_entries[i];
+    memset(&entry, 0, sizeof(entry));
+    entry.name_offset = new_names.size();
+    entry.name_length = sources[i].name.size();
+    new_names += sources[i].name;
+    lexicon.add(lexiconKey(sources[i].lower_name));
+
+    LifeBoard board;
+    readPattern(sources[i].path, board);
+
+    unsigned top, left, bottom, right;
+    if(!board.boundingBox(&top, &left, &bottom, &right))
+      continue;
+
+    // crop to the live cells so stamping never copies empty margins
+    LifeBoard cropped(bottom - top + 1, right - left + 1);
+    cropped.stamp(board, -(int)top, -(int)left);
+
+    entry.rows = cropped.getRows();
+    entry.cols = cropped.getCols();
+    entry.words = cropped.getUsedWords();
+    entry.bits_offset = sizeof(uint64_t) * bits.size();
+    for(unsigned r = 0; r < cropped.getRows(); ++r)
+      bits.insert(bits.end(), cropped.getRow(r), cropped.getRow(r) + cropped.getUsedWords());
+  }
+
+  new_header.names_offset = sizeof(CatalogHeader) + (sizeof(CatalogEntry) * new_entries.size());
+  new_header.bits_offset = (new_header.names_offset + new_names.size() + 63) & ~63ULL;
+  for(size_t i = 0; i < new_entries.size(); ++i)
+    new_entries[i].bits_offset += new_header.bits_offset;
+
+  // written aside and renamed so a reader never maps half an index
+  std::string index_file = dir + "/" CATALOG_INDEX_FILE;
+  std::string temp_file = index_file + ".tmp";
+  std::ofstream outfile(temp_file.c_str(), std::ios::out|std::ios::binary|std::ios::trunc);
+  if(outfile.fail())
+    Error("Couldn't open catalog index " + temp_file);
+
+  std::string padding(new_header.bits_offset - new_header.names_offset - new_names.size(), '\0');
+  outfile.write((const char*)&new_header, sizeof(new_header));
+  outfile.write((const char*)new_entries.data(), sizeof(CatalogEntry) * new_entries.size());
+  outfile.write(new_names.data(), new_names.size());
+  outfile.write(padding.data(), padding.size());
+  outfile.write((const char*)bits.data(), sizeof(uint64_t) * bits.size());
+  outfile.close();
+  if(outfile.fail())
+    Error("Couldn't write catalog index " + temp_file);
+
+  lexicon.writeMappedFile(dir + "/" CATALOG_NAMES_FILE);
+  if(rename(temp_file.c_str(), index_file.c_str()) != 0)
+    Error("Couldn't write catalog index " + index_file);
+
+  // the next lookup maps the new index
+  if(map != nullptr)
+    munmap(map, map_size);
+  map = nullptr;
+  loaded = false;
+
+  return sources.size();
+}
+
+void PatternCatalog::load(){
+  if(loaded)
+    return;
+
+  std::string index_file = dir + "/" CATALOG_INDEX_FILE;
+  int fd = open(index_file.c_str(), O_RDONLY);
+  if(fd < 0){
+    build();
+    fd = open(index_file.c_str(), O_RDONLY);
+    if(fd < 0)
+      Error("Couldn't open catalog index " + index_file);
+  }
+
+  struct stat file_stat;
+  if(fstat(fd, &file_stat) != 0 || (size_t)file_stat.st_size < sizeof(CatalogHeader)){
+    close(fd);
+    Error("Improperly formed catalog index " + index_file);
+  }
+
+  map_size = file_stat.st_size;
+  map = mmap(nullptr, map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(map == MAP_FAILED){
+    map = nullptr;
+    Error("Couldn't map catalog index " + index_file);
+  }
+
+  header = (const CatalogHeader*)map;
+  if(memcmp(header->magic, CATALOG_MAGIC, sizeof(CATALOG_MAGIC)) != 0 ||
+     header->version != CATALOG_VERSION ||
+     header->names_offset != sizeof(CatalogHeader) + (sizeof(CatalogEntry) * header->num_entries) ||
+     header->bits_offset < header->names_offset || header->bits_offset > map_size)
+    Error("Improperly formed catalog index " + index_file);
+
+  entries = (const CatalogEntry*)((const char*)map + sizeof(CatalogHeader));
+  names = (const char*)map + header->names_offset;
+
+  name_index.clear();
+  name_index.addWordsFromFile(dir + "/" CATALOG_NAMES_FILE);
+  loaded = true;
+}
+
+std::string PatternCatalog::entryName(unsigned i) const{
+  return std::string(names + entries[i].name_offset, entries[i].name_length);
+}
+
+unsigned PatternCatalog::lowerBound(const std::string& lower_name) const{
+  unsigned lo = 0, hi = header->num_entries;
+  while(lo < hi){
+    unsigned mid = lo + (hi - lo) / 2;
+    if(compareLower(names + entries[mid].name_offset, entries[mid].name_length, lower_name) < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+const CatalogEntry* PatternCatalog::find(std::string name){
+  load();
+
+  std::string lower_name = ConvertToLowerCase(name);
+  if(!name_index.containsWord(lexiconKey(lower_name)))
+    return nullptr;
+
+  unsigned i = lowerBound(lower_name);
+  if(i == header->num_entries ||
+     compareLower(names + entries[i].name_offset, entries[i].name_length, lower_name) != 0)
+    return nullptr;
+
+  const CatalogEntry* entry = &entries[i];
+  if(entry->bits_offset + (sizeof(uint64_t) * entry->rows * entry->words) > map_size)
+    Error("Improperly formed catalog index " + dir + "/" CATALOG_INDEX_FILE);
+
+  return entry;
+}
+
+const uint64_t* PatternCatalog::getBits(const CatalogEntry* entry) const{
+  return (const uint64_t*)((const char*)map + entry->bits_offset);
+}
+
+bool PatternCatalog::stamp(std::string name, LifeBoard& board, int top, int left){
+  const CatalogEntry* entry = find(name);
+  if(entry == nullptr)
+    return false;
+
+  board.stamp(getBits(entry), entry->rows, entry->words, entry->words, top, left);
+  return true;
+}
+
+std::vector<std::string> PatternCatalog::complete(std::string prefix, unsigned max_names){
+  load();
+
+  std::vector<std::string> matches;
+  std::string lower_prefix = ConvertToLowerCase(prefix);
+  if(!name_index.containsPrefix(lexiconKey(lower_prefix)))
+    return matches;
+
+  for(unsigned i = lowerBound(lower_prefix); i < header->num_entries; ++i){
+    if(compareLower(names + entries[i].name_offset, entries[i].name_length, lower_prefix, true) != 0 ||
+       (max_names != 0 && matches.size() == max_names))
+      break;
+    matches.push_back(entryName(i));
+  }
+
+  return matches;
+}
+
+unsigned PatternCatalog::getNumPatterns(){
+  load();
+  return header->num_entries;
+}
+
+#endif
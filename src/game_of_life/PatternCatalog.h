@@ -0,0 +1,89 @@
+#ifndef _PATTERN_CATALOG_H
+#define _PATTERN_CATALOG_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../lpc_lib/lexicon.h"
+#include "LifeBoard.h"
+
+#define CATALOG_INDEX_FILE "catalog.index"
+#define CATALOG_NAMES_FILE "catalog.dawg"
+#define CATALOG_MAGIC "GOLCATL"
+#define CATALOG_VERSION 1
+
+// Fixed header of a catalog index, in host byte order. The entries
+// follow it, sorted by lowercased name, then the names and then every
+// pattern's bitmap.
+struct CatalogHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t num_entries;
+  uint64_t names_offset;
+  uint64_t bits_offset;
+  uint8_t reserved[32];
+};
+
+// A pattern cropped to its live cells. Its bitmap is rows rows of
+// words packed words, laid out like a LifeBoard row without the padding.
+struct CatalogEntry {
+  uint32_t name_offset;   // from names_offset
+  uint32_t name_length;
+  uint32_t rows;
+  uint32_t cols;
+  uint32_t words;
+  uint32_t reserved;
+  uint64_t bits_offset;   // from the start of the file
+};
+
+static_assert(sizeof(CatalogHeader) == 64, "entries must stay 8-byte aligned");
+static_assert(sizeof(CatalogEntry) == 32, "entries must stay 8-byte aligned");
+
+// A directory of named patterns (any readable format but snapshots),
+// each named after its file without the extension. build() parses them
+// all once into catalog.index, along with catalog.dawg, a mapped
+// Lexicon of the names used to cut prefix searches short. Nothing is
+// opened until the first lookup, which maps both files; the bitmaps
+// are only read as patterns are stamped. Names are case-insensitive.
+class PatternCatalog {
+  private:
+    std::string dir;
+    bool loaded;
+
+    void* map;
+    size_t map_size;
+    const CatalogHeader* header;
+    const CatalogEntry* entries;
+    const char* names;
+    Lexicon name_index;
+
+    void load();
+    std::string entryName(unsigned i) const;
+    unsigned lowerBound(const std::string& lower_name) const;
+
+  public:
+    PatternCatalog(std::string _dir);
+    ~PatternCatalog();
+
+    // Parses every pattern in the directory and writes a fresh index,
+    // returns how many patterns it holds
+    unsigned build();
+
+    // Null if there's no pattern by that name
+    const CatalogEntry* find(std::string name);
+
+    // The pattern's bitmap, ready to hand to LifeBoard::stamp
+    const uint64_t* getBits(const CatalogEntry* entry) const;
+
+    // ORs the named pattern into the board with its top left corner at
+    // (top, left). Returns false if there's no pattern by that name.
+    bool stamp(std::string name, LifeBoard& board, int top, int left);
+
+    // Names starting with prefix in sorted order, at most max_names of
+    // them if it isn't 0
+    std::vector<std::string> complete(std::string prefix, unsigned max_names = 0);
+
+    unsigned getNumPatterns();
+};
+
+#endif
@@ -0,0 +1,572 @@
+/*
+ *  Author: Abraham Cardenas / https://github.com/Abe-Crdns
+ */
+
+#ifndef _PATTERN_FILE_CPP
+#define _PATTERN_FILE_CPP
+
+#include <fstream>
+#include <vector>
+#include <cctype>
+#include <climits>
+#include <cstdlib>
+#include <sstream>
+#include <string_view>
+#include "../lpc_lib/lpclib.h"
+#include "../lpc_lib/scanner.h"
+#include "PatternFile.h"
+#include "Snapshot.h"
+
+// Golly wraps RLE lines at 70 characters
+#define RLE_LINE_LENGTH 70
+
+// Most words a board buffer may take to flatten a whole macrocell
+// pattern onto (1 GB, each board has two), bigger ones are loaded as
+// a MacrocellPattern and stamped in windows
+#define MAX_FLAT_WORDS (1ULL << 27)
+
+static std::string fileExtension(std::string filename){
+  size_t dot = filename.find_last_of('.');
+  if(dot == std::string::npos)
+    return "";
+  return ConvertToLowerCase(filename.substr(dot + 1));
+}
+
+// Grows the board to fit the pattern and returns the top left
+// corner that centers it
+static void placePattern(LifeBoard& board, unsigned pat_rows, unsigned pat_cols,
+                         unsigned* top, unsigned* left){
+  if(board.getRows() < pat_rows || board.getCols() < pat_cols){
+    unsigned new_rows = board.getRows() < pat_rows ? pat_rows : board.getRows();
+    unsigned new_cols = board.getCols() < pat_cols ? pat_cols : board.getCols();
+    board.resize(new_rows, new_cols);
+  }
+  else
+    board.clear();
+
+  *top = (board.getRows() - pat_rows) / 2;
+  *left = (board.getCols() - pat_cols) / 2;
+}
+
+// Plaintext (.cells): '!' comment lines, then one line per row
+// with 'O' for a live cell and '.' for a dead one
+static void readPlaintext(std::string filename, LifeBoard& board){
+  std::ifstream infile(filename.c_str());
+  if(infile.fail())
+    Error("Couldn't open pattern file " + filename);
+
+  std::vector<std::string> lines;
+  unsigned pat_cols = 0;
+  std::string line;
+
+  while(getline(infile, line)){
+    if(!line.empty() && line[line.size() - 1] == '\r')
+      line.erase(line.size() - 1);
+    if(!line.empty() && line[0] == '!')
+      continue;
+
+    lines.push_back(line);
+    if(line.size() > pat_cols)
+      pat_cols = line.size();
+  }
+
+  unsigned top, left;
+  placePattern(board, lines.size(), pat_cols, &top, &left);
+
+  for(unsigned i = 0; i < lines.size(); ++i){
+    for(unsigned j = 0; j < lines[i].size(); ++j){
+      char ch = lines[i][j];
+      if(ch == 'O' || ch == '*')
+        board.setCell(top + i, left + j, true);
+      else if(ch != '.')
+        Error("Improperly formed pattern file " + filename);
+    }
+  }
+}
+
+static void writePlaintext(std::string filename, const LifeBoard& board){
+  std::ofstream outfile(filename.c_str());
+  if(outfile.fail())
+    Error("Couldn't open pattern file " + filename);
+
+  outfile << "!Generation: " << board.getGeneration() << "\n";
+
+  unsigned top, left, bottom, right;
+  if(!board.boundingBox(&top, &left, &bottom, &right))
+    return;
+
+  outfile << "!Position: " << left << " " << top << "\n";
+
+  std::string line;
+  for(unsigned i = top; i <= bottom; ++i){
+    line.clear();
+    for(unsigned j = left; j <= right; ++j)
+      line += board.getCell(i, j) ? 'O' : '.';
+
+    // trailing dead cells are implied
+    size_t end = line.find_last_of('O');
+    line.erase(end == std::string::npos ? 0 : end + 1);
+    outfile << line << "\n";
+  }
+}
+
+static bool isRuleB3S23(std::string rule){
+  rule = ConvertToUpperCase(rule);
+  return rule == "B3/S23" || rule == "S23/B3" || rule == "23/3";
+}
+
+// Next token that isn't a space or tab, newlines are returned
+static std::string_view nextNonSpace(Scanner& scanner){
+  std::string_view token = scanner.nextTokenView();
+  while(token == " " || token == "\t" || token == "\r")
+    token = scanner.nextTokenView();
+  return token;
+}
+
+static void skipLine(Scanner& scanner){
+  while(scanner.hasMoreTokens() && scanner.nextTokenView() != "\n");
+}
+
+static unsigned long long parseNumber(std::string filename, std::string value){
+  char* end = nullptr;
+  unsigned long long num = strtoull(value.c_str(), &end, 10);
+
+  if(value.empty() || *end != '\0')
+    Error("Improperly formed pattern file " + filename);
+
+  return num;
+}
+
+// Reads "key = value" pairs up to the end of the header line
+static void readRLEHeader(Scanner& scanner, std::string filename,
+                          unsigned* pat_rows, unsigned* pat_cols){
+  bool has_x = false, has_y = false;
+  std::string key = "x";
+
+  while(true){
+    if(nextNonSpace(scanner) != "=")
+      Error("Improperly formed RLE header in " + filename);
+
+    std::string value;
+    std::string_view token = nextNonSpace(scanner);
+    while(token != "," && token != "\n" && token != ""){
+      if(token != " " && token != "\t" && token != "\r")
+        value += token;
+      token = scanner.nextTokenView();
+    }
+
+    if(key == "x"){
+      *pat_cols = parseNumber(filename, value);
+      has_x = true;
+    }
+    else if(key == "y"){
+      *pat_rows = parseNumber(filename, value);
+      has_y = true;
+    }
+    else if(key == "rule" && !isRuleB3S23(value))
+      Error("Unsupported rule " + value + " in " + filename);
+
+    if(token != ",")
+      break;
+    key = nextNonSpace(scanner);
+  }
+
+  if(!has_x || !has_y)
+    Error("Improperly formed RLE header in " + filename);
+}
+
+// RLE (.rle): '#' comment lines, a header line such as
+// "x = 3, y = 3, rule = B3/S23", then runs of 'b' (dead) and 'o'
+// (alive) with '$' ending a row and '!' ending the pattern. Runs are
+// written straight into the board's words as they are scanned, from
+// tokens that point into the mapped file.
+static void readRLE(std::string filename, LifeBoard& board){
+  Scanner scanner;
+  if(!scanner.setInputFile(filename))
+    Error("Couldn't open pattern file " + filename);
+
+  unsigned long long gen = 0;
+  unsigned pat_rows = 0, pat_cols = 0;
+  bool has_header = false;
+
+  while(!has_header && scanner.hasMoreTokens()){
+    std::string_view token = nextNonSpace(scanner);
+
+    if(token == "\n")
+      continue;
+    else if(token == "#"){
+      // Golly's "#CXRLE Pos=x,y Gen=n" line carries the generation,
+      // a bare '#' already ends at the newline just read
+      token = scanner.nextTokenView();
+      if(token == "\n")
+        continue;
+      if(token != "CXRLE"){
+        skipLine(scanner);
+        continue;
+      }
+
+      token = scanner.nextTokenView();
+      while(token != "\n" && token != ""){
+        if(token == "Gen" && nextNonSpace(scanner) == "=")
+          gen = parseNumber(filename, std::string(nextNonSpace(scanner)));
+        token = scanner.nextTokenView();
+      }
+    }
+    else if(token == "x"){
+      readRLEHeader(scanner, filename, &pat_rows, &pat_cols);
+      has_header = true;
+    }
+    else
+      Error("Improperly formed RLE file " + filename);
+  }
+
+  if(!has_header)
+    Error("Missing RLE header in " + filename);
+
+  unsigned top, left;
+  placePattern(board, pat_rows, pat_cols, &top, &left);
+  board.setGeneration(gen);
+
+  unsigned long long row = 0, col = 0, count = 0;
+  bool done = false;
+
+  while(!done && scanner.hasMoreTokens()){
+    std::string_view token = scanner.nextTokenView();
+
+    for(size_t i = 0; i < token.size() && !done; ++i){
+      char ch = token[i];
+
+      // every run is checked against what's left of the header's box
+      // before it's added, so neither it nor the position can wrap
+      if(isdigit(ch)){
+        count = (count * 10) + (ch - '0');
+        if(count > pat_rows && count > pat_cols)
+          Error("RLE pattern exceeds its header size in " + filename);
+        continue;
+      }
+      if(isspace(ch))
+        continue;
+
+      unsigned long long run = (count == 0) ? 1 : count;
+      count = 0;
+
+      if(ch == 'b' || ch == '.'){
+        if(run > pat_cols - col)
+          Error("RLE pattern exceeds its header size in " + filename);
+        col += run;
+      }
+      else if(ch == '$'){
+        if(row + run > pat_rows)
+          Error("RLE pattern exceeds its header size in " + filename);
+        row += run;
+        col = 0;
+      }
+      else if(ch == '!')
+        done = true;
+      else if(isalpha(ch)){
+        if(row >= pat_rows || run > pat_cols - col)
+          Error("RLE pattern exceeds its header size in " + filename);
+        board.setRun(top + row, left + col, run);
+        col += run;
+      }
+      else
+        Error("Improperly formed RLE file " + filename);
+    }
+  }
+}
+
+// Adds one run to the current line, wrapping it first if it
+// would run past the line length
+static void appendRun(std::ostream& out, std::string& line, 
+                      unsigned long long count, char tag){
+  std::string run;
+  if(count > 1)
+    run = std::to_string(count);
+  run += tag;
+
+  if(line.size() + run.size() > RLE_LINE_LENGTH){
+    out << line << "\n";
+    line.clear();
+  }
+  line += run;
+}
+
+static void writeRLE(std::string filename, const LifeBoard& board){
+  std::ofstream outfile(filename.c_str(), std::ios::out|std::ios::binary);
+  if(outfile.fail())
+    Error("Couldn't open pattern file " + filename);
+
+  unsigned top, left, bottom, right;
+  if(!board.boundingBox(&top, &left, &bottom, &right)){
+    outfile << "#CXRLE Gen=" << board.getGeneration() << "\n"
+            << "x = 0, y = 0, rule = B3/S23\n!\n";
+    return;
+  }
+
+  outfile << "#CXRLE Pos=" << left << "," << top 
+          << " Gen=" << board.getGeneration() << "\n"
+          << "x = " << (right - left + 1) << ", y = " << (bottom - top + 1) 
+          << ", rule = B3/S23\n";
+
+  std::string line;
+  unsigned long long empty_rows = 0;
+
+  for(unsigned i = top; i <= bottom; ++i){
+    unsigned col = left;
+
+    while(true){
+      unsigned start = board.nextCell(i, col, true);
+      if(start > right)
+        break;
+      unsigned end = board.nextCell(i, start, false);
+      if(end > right + 1)
+        end = right + 1;
+
+      if(empty_rows > 0){
+        appendRun(outfile, line, empty_rows, '$');
+        empty_rows = 0;
+      }
+      if(start > col)
+        appendRun(outfile, line, start - col, 'b');
+      appendRun(outfile, line, end - start, 'o');
+      col = end;
+    }
+
+    ++empty_rows;
+  }
+
+  appendRun(outfile, line, 1, '!');
+  outfile << line << "\n";
+}
+
+static std::string trimSpaces(std::string str){
+  size_t first = str.find_first_not_of(" \t");
+  if(first == std::string::npos)
+    return "";
+  return str.substr(first, str.find_last_not_of(" \t") - first + 1);
+}
+
+// Macrocell (.mc): a "[M2]" line, '#' lines (#R rule, #G generation),
+// then one node per line numbered from 1. Leaves are 8x8 cells written
+// as '.' and '*' with '$' ending each row, the rest are
+// "level nw ne sw se" with 0 for an empty child. The last node is the
+// root. Identical nodes are merged as they're read, so the tree costs
+// memory per distinct node no matter how large the pattern's area is.
+MacrocellPattern::MacrocellPattern(std::string filename){
+  std::ifstream infile(filename.c_str());
+  if(infile.fail())
+    Error("Couldn't open pattern file " + filename);
+
+  std::string line;
+  if(!getline(infile, line) || line.compare(0, 4, "[M2]") != 0)
+    Error("Improperly formed macrocell file " + filename);
+
+  std::vector<unsigned> tree_ids(1, 0);   // file node number to tree node
+  std::vector<unsigned> levels(1, 0);
+  generation = 0;
+
+  while(getline(infile, line)){
+    if(!line.empty() && line[line.size() - 1] == '\r')
+      line.erase(line.size() - 1);
+    if(line.empty())
+      continue;
+
+    if(line[0] == '#'){
+      std::string value = trimSpaces(line.size() > 2 ? line.substr(2) : "");
+      if(line.compare(0, 2, "#G") == 0)
+        generation = parseNumber(filename, value);
+      else if(line.compare(0, 2, "#R") == 0 && !isRuleB3S23(value))
+        Error("Unsupported rule " + value + " in " + filename);
+      continue;
+    }
+
+    if(line[0] == '.' || line[0] == '*' || line[0] == '$'){
+      uint64_t bits = 0;
+      unsigned row = 0, col = 0;
+
+      for(unsigned i = 0; i < line.size(); ++i){
+        if(line[i] == '$'){
+          ++row;
+          col = 0;
+        }
+        else if(line[i] == '.')
+          ++col;
+        else if(line[i] == '*' && row < 8 && col < 8)
+          bits |= 1ULL << ((8 * row) + col++);
+        else
+          Error("Improperly formed macrocell file " + filename);
+      }
+
+      tree_ids.push_back(tree.makeLeaf(bits));
+      levels.push_back(QUAD_LEAF_LEVEL);
+      continue;
+    }
+
+    std::istringstream fields(line);
+    unsigned level;
+    unsigned long long child[4];
+    if(!(fields >> level >> child[0] >> child[1] >> child[2] >> child[3]))
+      Error("Improperly formed macrocell file " + filename);
+    if(level <= QUAD_LEAF_LEVEL || level > QUAD_MAX_LEVEL)
+      Error("Unsupported macrocell node level in " + filename);
+
+    for(unsigned k = 0; k < 4; ++k){
+      if(child[k] >= tree_ids.size() || (child[k] != 0 && levels[child[k]] != level - 1))
+        Error("Improperly formed macrocell file " + filename);
+    }
+
+    tree_ids.push_back(tree.makeBranch(level, tree_ids[child[0]], tree_ids[child[1]],
+                                       tree_ids[child[2]], tree_ids[child[3]]));
+    levels.push_back(level);
+  }
+
+  root = tree_ids.back();
+  if(!tree.boundingBox(root, &top, &left, &bottom, &right))
+    root = 0;
+}
+
+unsigned long long MacrocellPattern::getGeneration() const{
+  return generation;
+}
+
+bool MacrocellPattern::isEmpty() const{
+  return root == 0;
+}
+
+uint64_t MacrocellPattern::getHeight() const{
+  return root == 0 ? 0 : bottom - top + 1;
+}
+
+uint64_t MacrocellPattern::getWidth() const{
+  return root == 0 ? 0 : right - left + 1;
+}
+
+bool MacrocellPattern::getCell(uint64_t row, uint64_t col) const{
+  if(row >= getHeight() || col >= getWidth())
+    return false;
+
+  // walk down from the root, keeping the cell relative to each node
+  row += top;
+  col += left;
+  unsigned id = root;
+  while(id != 0 && tree.getNode(id).level > QUAD_LEAF_LEVEL){
+    const QuadTree::Node& node = tree.getNode(id);
+    uint64_t half = 1ULL << (node.level - 1);
+    id = node.child[2 * (row >= half) + (col >= half)];
+    row &= half - 1;
+    col &= half - 1;
+  }
+
+  return id != 0 && ((tree.getNode(id).leaf >> (8 * row + col)) & 1);
+}
+
+void MacrocellPattern::stamp(LifeBoard& board, long long row, long long col) const{
+  // past the live cells, also keeps the offsets below from overflowing
+  if(root == 0 || row <= -(long long)getHeight() || col <= -(long long)getWidth())
+    return;
+
+  tree.render(root, board, row - (long long)top, col - (long long)left);
+}
+
+// Flattens the whole pattern, use a MacrocellPattern for windows of
+// ones too big for that
+static void readMacrocell(std::string filename, LifeBoard& board){
+  MacrocellPattern pattern(filename);
+  unsigned pat_top, pat_left;
+
+  // the board it's grown to, not just the pattern
+  uint64_t rows = pattern.getHeight() > board.getRows() ? pattern.getHeight() : board.getRows();
+  uint64_t cols = pattern.getWidth() > board.getCols() ? pattern.getWidth() : board.getCols();
+  if(rows > UINT_MAX || cols > UINT_MAX || rows * LifeBoard::rowWordsFor(cols) > MAX_FLAT_WORDS)
+    Error("Pattern is too large to flatten onto a board, load a window of it with --region: " + filename);
+
+  placePattern(board, pattern.getHeight(), pattern.getWidth(), &pat_top, &pat_left);
+  pattern.stamp(board, pat_top, pat_left);
+  board.setGeneration(pattern.getGeneration());
+}
+
+// Writes the node's children before the node itself so every line only
+// refers back to earlier ones, and each shared node is written once
+static unsigned writeMacrocellNode(std::ostream& out, const QuadTree& tree, unsigned id,
+                                   std::vector<unsigned>& file_ids, unsigned* num_written){
+  if(id == 0 || file_ids[id] != 0)
+    return file_ids[id];
+
+  const QuadTree::Node& node = tree.getNode(id);
+
+  if(node.level == QUAD_LEAF_LEVEL){
+    for(unsigned row = 0; row < 8; ++row){
+      unsigned bits = (node.leaf >> (8 * row)) & 0xFF;
+      for(unsigned col = 0; bits != 0; ++col, bits >>= 1)
+        out << ((bits & 1) ? '*' : '.');
+      out << '$';
+    }
+    out << "\n";
+  }
+  else{
+    unsigned child[4];
+    for(unsigned k = 0; k < 4; ++k)
+      child[k] = writeMacrocellNode(out, tree, node.child[k], file_ids, num_written);
+
+    out << node.level << " " << child[0] << " " << child[1] << " "
+        << child[2] << " " << child[3] << "\n";
+  }
+
+  file_ids[id] = ++(*num_written);
+  return file_ids[id];
+}
+
+static void writeMacrocell(std::string filename, const LifeBoard& board){
+  std::ofstream outfile(filename.c_str(), std::ios::out|std::ios::binary);
+  if(outfile.fail())
+    Error("Couldn't open pattern file " + filename);
+
+  outfile << "[M2] (GameOfLife)\n"
+          << "#R B3/S23\n"
+          << "#G " << board.getGeneration() << "\n";
+
+  QuadTree tree;
+  unsigned top, left;
+  unsigned root = tree.fromBoard(board, &top, &left);
+
+  if(root == 0){
+    outfile << "$$$$$$$$\n";
+    return;
+  }
+
+  std::vector<unsigned> file_ids(tree.getNumNodes(), 0);
+  unsigned num_written = 0;
+  writeMacrocellNode(outfile, tree, root, file_ids, &num_written);
+}
+
+void readPattern(std::string filename, LifeBoard& board){
+  std::string ext = fileExtension(filename);
+
+  if(ext == "cells" || ext == "txt")
+    readPlaintext(filename, board);
+  else if(ext == "rle")
+    readRLE(filename, board);
+  else if(ext == "mc")
+    readMacrocell(filename, board);
+  else if(ext == "snap")
+    readSnapshot(filename, board);
+  else
+    Error("Unsupported pattern format " + filename);
+}
+
+void writePattern(std::string filename, const LifeBoard& board){
+  std::string ext = fileExtension(filename);
+
+  if(ext == "cells" || ext == "txt")
+    writePlaintext(filename, board);
+  else if(ext == "rle")
+    writeRLE(filename, board);
+  else if(ext == "mc")
+    writeMacrocell(filename, board);
+  else if(ext == "snap")
+    writeSnapshot(filename, board);
+  else
+    Error("Unsupported pattern format " + filename);
+}
+
+#endif
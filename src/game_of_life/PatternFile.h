@@ -0,0 +1,45 @@
+#ifndef _PATTERN_FILE_H
+#define _PATTERN_FILE_H
+
+#include <string>
+#include <cstdint>
+#include "LifeBoard.h"
+#include "private/QuadTree.h"
+
+// Reads a pattern into the middle of the board. The board is grown
+// to the pattern's size if it's smaller. The format is picked from
+// the file extension; malformed files call Error. A snapshot (.snap)
+// replaces the board outright, size and boundary scheme included.
+void readPattern(std::string filename, LifeBoard& board);
+
+// Writes the live region of the board, or all of it for a snapshot
+void writePattern(std::string filename, const LifeBoard& board);
+
+// A macrocell pattern kept as its quadtree, so loading costs memory per
+// distinct node however large its area is. Only the windows stamped
+// onto a board are ever flattened. Coordinates are relative to the top
+// left corner of the pattern's live cells.
+class MacrocellPattern {
+  private:
+    QuadTree tree;
+    unsigned root;
+    unsigned long long generation;
+    uint64_t top, left, bottom, right;   // live cells from the root's corner
+
+  public:
+    // Reads the file, malformed files call Error
+    MacrocellPattern(std::string filename);
+
+    unsigned long long getGeneration() const;
+    bool isEmpty() const;
+    uint64_t getHeight() const;   // of the live cells, 0 if empty
+    uint64_t getWidth() const;
+    bool getCell(uint64_t row, uint64_t col) const;
+
+    // ORs the live cells onto the board with their top left corner at
+    // (row, col), clipping whatever falls off it. Negative offsets pick
+    // the window starting at (-row, -col).
+    void stamp(LifeBoard& board, long long row, long long col) const;
+};
+
+#endif
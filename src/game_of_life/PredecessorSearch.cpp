@@ -0,0 +1,410 @@
+/*
+ *  Author: Abraham Cardenas / https://github.com/Abe-Crdns
+ */
+
+#ifndef _PREDECESSOR_SEARCH_CPP
+#define _PREDECESSOR_SEARCH_CPP
+
+#include <iostream>
+#include <thread>
+#include "../lpc_lib/lpclib.h"
+#include "BatchRun.h"
+#include "PatternFile.h"
+#include "PredecessorSearch.h"
+#include "private/SplitMix.h"
+#include "private/Timer.h"
+
+// Nodes a thread counts before adding them to the total
+static const unsigned long long NODES_PER_FLUSH = 1 << 14;
+
+// The first three columns of the first three rows, one task each
+static const unsigned NUM_PREFIXES = 512;
+
+// Next state of the middle cell of a 3x3 block given as three rows of
+// three bits, the middle cell being bit 1 of b
+static bool nextState(unsigned a, unsigned b, unsigned c){
+  unsigned count = __builtin_popcount(a) + __builtin_popcount(c) + (b & 1) + ((b >> 2) & 1);
+  return count == 3 || ((b & 2) && count == 2);
+}
+
+bool PredecessorSearch::RowPair::operator==(const RowPair& other) const{
+  return above == other.above && below == other.below && row == other.row;
+}
+
+size_t PredecessorSearch::RowPairHash::operator()(const RowPair& pair) const{
+  uint64_t state = pair.above ^ (pair.below * 0x9E3779B97F4A7C15ULL) ^ pair.row;
+  return splitMix64(&state);
+}
+
+PredecessorSearch::PredecessorSearch(const LifeBoard& _target, int edges){
+  rows = _target.getRows();
+  cols = _target.getCols();
+  if(rows == 0 || cols == 0)
+    Error("There's no target to find a parent of");
+  if(cols > PARENT_MAX_COLS)
+    Error("Parents are only searched for targets up to " + std::to_string(PARENT_MAX_COLS) +
+          " columns wide");
+
+  width = cols + 2;
+  target.resize(rows);
+  for(unsigned i = 0; i < rows; ++i)
+    target[i] = _target.getRow(i)[0] << 1;
+
+  // confined sides keep the ring around the target and the target's
+  // own edge dead, so whatever's born outside it dies out
+  uint64_t all_cells = (width == 64) ? ~0ULL : (1ULL << width) - 1;
+  uint64_t dead_cols = 0;
+  if(edges & (peLeft | peLeftEdge))
+    dead_cols |= (edges & peLeft) ? 3 : 1;
+  if(edges & (peRight | peRightEdge))
+    dead_cols |= ((edges & peRight) ? 3ULL : 2ULL) << (width - 2);
+
+  free_cells.assign(rows + 2, all_cells & ~dead_cols);
+  if(edges & (peTop | peTopEdge))
+    free_cells[0] = 0;
+  if(edges & peTop)
+    free_cells[1] = 0;
+  if(edges & (peBottom | peBottomEdge))
+    free_cells[rows + 1] = 0;
+  if(edges & peBottom)
+    free_cells[rows] = 0;
+
+  buildTables();
+  max_nodes = 0;
+  nodes = 0;
+  stopping = false;
+  stopped = false;
+  outcome = poNone;
+}
+
+void PredecessorSearch::buildTables(){
+  for(unsigned t = 0; t < 2; ++t){
+    for(unsigned i = 0; i < 256; ++i)
+      next_cell[t][i] = 0;
+    for(unsigned i = 0; i < 64; ++i)
+      next_column[t][i] = 0;
+  }
+
+  // three known cells above and beside, two of the new row
+  for(unsigned index = 0; index < 256; ++index){
+    unsigned a = index & 7, b = (index >> 3) & 7, c = index >> 6;
+    for(unsigned v = 0; v < 2; ++v)
+      next_cell[nextState(a, b, c | (v << 2))][index] |= 1 << v;
+  }
+
+  // two known columns of three rows, a new cell for each row
+  for(unsigned index = 0; index < 64; ++index){
+    unsigned a = index & 3, b = (index >> 2) & 3, c = index >> 4;
+    for(unsigned v = 0; v < 8; ++v){
+      bool next = nextState(a | ((v & 1) << 2), b | (((v >> 1) & 1) << 2), c | ((v >> 2) << 2));
+      next_column[next][index] |= 1 << v;
+    }
+  }
+}
+
+// Returns true once the search should stop
+bool PredecessorSearch::countNode(SearchContext& ctx){
+  if((++ctx.nodes % NODES_PER_FLUSH) == 0){
+    unsigned long long total = nodes.fetch_add(NODES_PER_FLUSH) + NODES_PER_FLUSH;
+    if(max_nodes != 0 && total >= max_nodes)
+      stopping = true;
+  }
+  return stopping.load(std::memory_order_relaxed);
+}
+
+// Whether some row below could still make the target row under these
+// two. A live target cell needs at most 3 live neighbors among the 5
+// known ones, which is counted for every column at once; a dead one
+// can always be had.
+bool PredecessorSearch::canContinue(unsigned row, uint64_t above, uint64_t below) const{
+  if(row >= rows)
+    return true;
+
+  uint64_t aw = above << 1, ae = above >> 1;
+  uint64_t bw = below << 1, be = below >> 1;
+
+  uint64_t ones_a = aw ^ above ^ ae, twos_a = (aw & above) | (ae & (aw ^ above));
+  uint64_t ones_b = bw ^ be, twos_b = bw & be;
+  uint64_t carry = ones_a & ones_b;
+  uint64_t fours = (twos_a & twos_b) | (carry & (twos_a ^ twos_b));
+
+  return (fours & target[row]) == 0;
+}
+
+void PredecessorSearch::found(const SearchContext& ctx){
+  std::lock_guard<std::mutex> lock(found_mutex);
+  if(outcome == poFound)
+    return;
+
+  parent.resize(rows + 2, width);
+  for(unsigned i = 0; i < rows + 2; ++i)
+    parent.getRow(i)[0] = ctx.rows[i];
+
+  outcome = poFound;
+  stopping = true;
+}
+
+// Parent rows 0 to row + 1 are set, the rest has to make target rows
+// row onwards. Returns true if the search should stop.
+bool PredecessorSearch::extendRows(SearchContext& ctx, unsigned row){
+  if(row == rows){
+    found(ctx);
+    return true;
+  }
+
+  RowPair pair = { ctx.rows[row], ctx.rows[row + 1], row };
+  if(ctx.dead_ends.count(pair))
+    return false;
+
+  if(buildRow(ctx, row, 0, 0))
+    return true;
+
+  if(ctx.dead_ends.size() >= PARENT_DEAD_STATES)
+    ctx.dead_ends.clear();
+  ctx.dead_ends.insert(pair);
+  return false;
+}
+
+// Tries each value of parent row row + 2's cell at col, the cells left
+// of it already set, keeping only those that make target row row
+bool PredecessorSearch::buildRow(SearchContext& ctx, unsigned row, unsigned col, uint64_t cells){
+  if(countNode(ctx))
+    return true;
+
+  uint64_t above = ctx.rows[row], middle = ctx.rows[row + 1];
+  if(col == width){
+    if(!canContinue(row + 1, middle, cells))
+      return false;
+    ctx.rows[row + 2] = cells;
+    return extendRows(ctx, row + 1);
+  }
+
+  unsigned allowed = 3;
+  if(col >= 2){
+    unsigned index = ((above >> (col - 2)) & 7) | (((middle >> (col - 2)) & 7) << 3) |
+                     (((cells >> (col - 2)) & 3) << 6);
+    allowed = next_cell[(target[row] >> (col - 1)) & 1][index];
+  }
+  if(((free_cells[row + 2] >> col) & 1) == 0)
+    allowed &= 1;
+
+  for(unsigned v = 0; v < 2; ++v){
+    if(((allowed >> v) & 1) && buildRow(ctx, row, col + 1, cells | ((uint64_t)v << col)))
+      return true;
+  }
+  return false;
+}
+
+// Same for the first three rows together, the cells of all three at
+// col, which have to make target row 0
+bool PredecessorSearch::buildFirstRows(SearchContext& ctx, unsigned col,
+                                       uint64_t a, uint64_t b, uint64_t c){
+  if(countNode(ctx))
+    return true;
+
+  if(col == width){
+    if(!canContinue(1, b, c))
+      return false;
+    ctx.rows[0] = a;
+    ctx.rows[1] = b;
+    ctx.rows[2] = c;
+    return extendRows(ctx, 1);
+  }
+
+  unsigned allowed = 0xFF;
+  if(col >= 2){
+    unsigned index = ((a >> (col - 2)) & 3) | (((b >> (col - 2)) & 3) << 2) |
+                     (((c >> (col - 2)) & 3) << 4);
+    allowed = next_column[(target[0] >> (col - 1)) & 1][index];
+  }
+
+  for(unsigned v = 0; v < 8; ++v){
+    if(((allowed >> v) & 1) == 0)
+      continue;
+
+    uint64_t va = v & 1, vb = (v >> 1) & 1, vc = v >> 2;
+    if((va & ~(free_cells[0] >> col)) || (vb & ~(free_cells[1] >> col)) ||
+       (vc & ~(free_cells[2] >> col)))
+      continue;
+
+    if(buildFirstRows(ctx, col + 1, a | (va << col), b | (vb << col), c | (vc << col)))
+      return true;
+  }
+  return false;
+}
+
+ParentOutcome PredecessorSearch::search(WorkerPool* pool, unsigned long long _max_nodes){
+  max_nodes = _max_nodes;
+  nodes = 0;
+  stopping = false;
+  if(stopped)
+    stopping = true;
+  outcome = poNone;
+
+  // threads take the prefixes in turn, each keeping its own dead ends
+  unsigned threads = (pool != nullptr) ? pool->getNumThreads() : 1;
+  std::atomic<unsigned> next_prefix(0);
+
+  auto work = [&](unsigned){
+    SearchContext ctx;
+    ctx.rows.assign(rows + 2, 0);
+    ctx.nodes = 0;
+
+    unsigned prefix;
+    while(!stopping && (prefix = next_prefix.fetch_add(1)) < NUM_PREFIXES){
+      uint64_t a = 0, b = 0, c = 0;
+      bool valid = true;
+
+      // the prefix has to get past the same checks buildFirstRows makes
+      for(unsigned col = 0; col < 3 && valid; ++col){
+        unsigned v = (prefix >> (3 * col)) & 7;
+        uint64_t va = v & 1, vb = (v >> 1) & 1, vc = v >> 2;
+
+        if(col == 2){
+          unsigned index = (a & 3) | ((b & 3) << 2) | ((c & 3) << 4);
+          valid = (next_column[(target[0] >> 1) & 1][index] >> v) & 1;
+        }
+        if((va & ~(free_cells[0] >> col)) || (vb & ~(free_cells[1] >> col)) ||
+           (vc & ~(free_cells[2] >> col)))
+          valid = false;
+
+        a |= va << col;
+        b |= vb << col;
+        c |= vc << col;
+      }
+
+      if(valid && buildFirstRows(ctx, 3, a, b, c))
+        break;
+    }
+
+    nodes += ctx.nodes % NODES_PER_FLUSH;
+  };
+
+  if(threads > 1)
+    pool->run(threads, work);
+  else
+    work(0);
+
+  if(outcome != poFound)
+    outcome = stopping ? poGaveUp : poNone;
+  return outcome;
+}
+
+void PredecessorSearch::stop(){
+  stopped = true;
+  stopping = true;
+}
+
+unsigned long long PredecessorSearch::getNodes() const{
+  return nodes;
+}
+
+const LifeBoard& PredecessorSearch::getParent() const{
+  return parent;
+}
+
+std::string parentOutcomeName(ParentOutcome outcome, int edges){
+  switch(outcome){
+    case poFound:
+      return "found";
+    case poNone:
+      return (edges & peConfined) ? "no parent within the margin" : "Garden of Eden";
+    default:
+      return "gave up";
+  }
+}
+
+static void printUsage(const char* prog){
+  std::cerr << "usage: " << prog << " parents --pattern <file> [options]\n"
+            << "  --pattern <file>             pattern whose parent to find\n"
+            << "  --margin <n>                 dead cells around the pattern that stay dead (default 2)\n"
+            << "  --edges <confined|free>      keep the parent inside the target, or let it spill (default confined)\n"
+            << "  --threads <n>                search threads (default: all cores)\n"
+            << "  --max-nodes <n>              give up after this many nodes (default: never)\n"
+            << "  --out <file>                 write the parent here\n";
+}
+
+int runParents(int argc, char* argv[]){
+  unsigned long long max_nodes = 0;
+  unsigned margin = 2;
+  unsigned threads = std::thread::hardware_concurrency();
+  int edges = peConfined;
+  std::string pattern_file, out_file;
+
+  for(int i = 2; i < argc; ++i){
+    std::string opt = argv[i];
+
+    if(i + 1 >= argc){
+      std::cerr << "Missing value for " << opt << std::endl;
+      printUsage(argv[0]);
+      return 1;
+    }
+    std::string val = argv[++i];
+
+    if(opt == "--pattern")
+      pattern_file = val;
+    else if(opt == "--margin")
+      margin = parseCount(opt, val);
+    else if(opt == "--threads")
+      threads = parseCount(opt, val);
+    else if(opt == "--max-nodes")
+      max_nodes = parseCount(opt, val);
+    else if(opt == "--out")
+      out_file = val;
+    else if(opt == "--edges"){
+      std::string scheme = ConvertToLowerCase(val);
+      if(scheme != "confined" && scheme != "free")
+        Error("Bad value for --edges: " + val);
+      edges = (scheme == "confined") ? peConfined : peFree;
+    }
+    else{
+      std::cerr << "Unknown option " << opt << std::endl;
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  if(pattern_file.empty()){
+    printUsage(argv[0]);
+    return 1;
+  }
+  if(threads == 0)
+    threads = 1;
+
+  // the pattern's live cells with the margin around them
+  LifeBoard board;
+  readPattern(pattern_file, board);
+  unsigned top = 0, left = 0, bottom = 0, right = 0;
+  if(!board.boundingBox(&top, &left, &bottom, &right))
+    Error("The pattern has no live cells");
+
+  LifeBoard target(bottom - top + 1 + (2 * margin), right - left + 1 + (2 * margin));
+  target.stamp(board, (int)margin - (int)top, (int)margin - (int)left);
+
+  WorkerPool pool(threads);
+  PredecessorSearch search(target, edges);
+  Timer run_timer;
+
+  run_timer.Start();
+  ParentOutcome outcome = search.search(&pool, max_nodes);
+  double elapsed = run_timer.GetDuration();
+
+  if(outcome == poFound && !out_file.empty())
+    writePattern(out_file, search.getParent());
+
+  std::cout << "target:       " << target.getRows() << "x" << target.getCols() << "\n"
+            << "threads:      " << pool.getNumThreads() << "\n"
+            << "result:       " << parentOutcomeName(outcome, edges) << "\n"
+            << "nodes:        " << search.getNodes() << "\n"
+            << "elapsed:      " << elapsed << " s\n";
+
+  if(elapsed > 0)
+    std::cout << "nodes/sec:    " << search.getNodes() / elapsed << "\n";
+
+  if(outcome == poFound)
+    std::cout << "population:   " << search.getParent().population() << " in the parent\n";
+
+  return 0;
+}
+
+#endif
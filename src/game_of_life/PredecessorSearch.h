@@ -0,0 +1,131 @@
+#ifndef _PREDECESSOR_SEARCH_H
+#define _PREDECESSOR_SEARCH_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "LifeBoard.h"
+#include "private/WorkerPool.h"
+
+// Widest target searched, so each parent row fits in a word
+#define PARENT_MAX_COLS 62
+
+// Rows known to lead nowhere kept by each thread before it starts over
+#define PARENT_DEAD_STATES (1 << 20)
+
+// Sides of the parent whose two outer rows or columns must stay dead,
+// so that nothing outside the target can come alive either. A side on
+// the edge of a flat board only needs the row or column past the edge
+// dead, since nothing is born off the board.
+enum ParentEdges{
+  peFree = 0,
+  peTop = 1,
+  peBottom = 2,
+  peLeft = 4,
+  peRight = 8,
+  peConfined = 15,
+  peTopEdge = 16,
+  peBottomEdge = 32,
+  peLeftEdge = 64,
+  peRightEdge = 128
+};
+
+enum ParentOutcome{
+  poFound,          // a parent is in getParent()
+  poNone,           // no parent within the edges searched
+  poGaveUp          // ran out of nodes first
+};
+
+// Looks for a board that steps into the target. Every cell of the
+// target counts, dead ones included, and a parent is two rows and
+// columns bigger: the target's cells and the ring around them. Parent
+// rows are found top to bottom, each one a cell at a time: a table of
+// the cells of three rows that step into each target cell cuts off a
+// row as soon as one of its cells can't work, and each finished row is
+// checked against the next target row a word at a time before going
+// deeper. Row pairs that led nowhere are remembered and not tried
+// again. The first three columns of the first three rows split the
+// search across the threads. Searching everything without finding a
+// parent proves the target can't be reached.
+class PredecessorSearch {
+  private:
+    // A pair of parent rows, and the target row they have to make
+    struct RowPair {
+      uint64_t above, below;
+      unsigned row;
+      bool operator==(const RowPair& other) const;
+    };
+
+    struct RowPairHash {
+      size_t operator()(const RowPair& pair) const;
+    };
+
+    // Per thread, so nothing's shared while searching
+    struct SearchContext {
+      std::vector<uint64_t> rows;
+      unsigned long long nodes;
+      std::unordered_set<RowPair, RowPairHash> dead_ends;
+    };
+
+    unsigned rows, cols;                // of the target
+    unsigned width;                     // of the parent, cols + 2
+    std::vector<uint64_t> target;       // target row i at parent columns 1 to cols
+    std::vector<uint64_t> free_cells;   // cells of each parent row that may be alive
+
+    // Next cells allowed by the last two, as a mask over their values,
+    // given the target cell they make: one cell when the two rows
+    // above it are known, or a cell of each of three rows at the start
+    uint8_t next_cell[2][256];
+    uint8_t next_column[2][64];
+
+    unsigned long long max_nodes;
+    std::atomic<unsigned long long> nodes;
+    std::atomic<bool> stopping;
+    std::atomic<bool> stopped;          // by stop(), for good
+    std::mutex found_mutex;
+    ParentOutcome outcome;
+    LifeBoard parent;
+
+    void buildTables();
+    bool countNode(SearchContext& ctx);
+    bool canContinue(unsigned row, uint64_t above, uint64_t below) const;
+    void found(const SearchContext& ctx);
+
+    bool extendRows(SearchContext& ctx, unsigned row);
+    bool buildRow(SearchContext& ctx, unsigned row, unsigned col, uint64_t cells);
+    bool buildFirstRows(SearchContext& ctx, unsigned col, uint64_t a, uint64_t b, uint64_t c);
+
+  public:
+    // Calls Error if the target is wider than PARENT_MAX_COLS
+    PredecessorSearch(const LifeBoard& _target, int edges = peFree);
+
+    // Searches until a parent turns up, every branch is ruled out or,
+    // if _max_nodes isn't 0, that many cells have been tried
+    ParentOutcome search(WorkerPool* pool = nullptr, unsigned long long _max_nodes = 0);
+
+    // Makes a search running on another thread give up as soon as its
+    // threads notice, and any later one give up straight away
+    void stop();
+
+    // Parent cells tried, each one a node
+    unsigned long long getNodes() const;
+
+    // The parent found, cols + 2 wide and rows + 2 high, its top left
+    // cell up and to the left of the target's
+    const LifeBoard& getParent() const;
+};
+
+// "found", "no parent within the margin" or "gave up". Finding no
+// parent only proves a Garden of Eden when no side was confined, so
+// it's named one only then.
+std::string parentOutcomeName(ParentOutcome outcome, int edges = peFree);
+
+// Headless search: "parents" followed by its options looks for a
+// parent of a pattern and reports nodes per second. Returns the exit
+// code.
+int runParents(int argc, char* argv[]);
+
+#endif
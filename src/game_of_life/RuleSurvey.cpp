@@ -0,0 +1,266 @@
+/*
+ *  Author: Abraham Cardenas / https://github.com/Abe-Crdns
+ */
+
+#ifndef _RULE_SURVEY_CPP
+#define _RULE_SURVEY_CPP
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include "../lpc_lib/lpclib.h"
+#include "BatchRun.h"
+#include "LifeEnsemble.h"
+#include "PatternFile.h"
+#include "RuleSurvey.h"
+#include "private/SplitMix.h"
+#include "private/Timer.h"
+
+// A board still running at the limit grows if any live cell is on
+// the outermost rows or columns
+static bool touchesEdge(const LifeEnsemble& ensemble, unsigned board){
+  unsigned rows = ensemble.getRows(), cols = ensemble.getCols();
+  for(unsigned j = 0; j < cols; ++j){
+    if(ensemble.getCell(board, 0, j) || ensemble.getCell(board, rows - 1, j))
+      return true;
+  }
+  for(unsigned i = 0; i < rows; ++i){
+    if(ensemble.getCell(board, i, 0) || ensemble.getCell(board, i, cols - 1))
+      return true;
+  }
+  return false;
+}
+
+std::vector<SurveyResult> surveyRules(const LifeBoard& board, const std::vector<BSRule>& rules,
+                                      unsigned long long max_gens, WorkerPool* pool){
+  // rules that use the same counts go next to each other, so most
+  // groups only look at the counts of one kernel shape
+  std::vector<unsigned> order(rules.size());
+  for(unsigned k = 0; k < order.size(); ++k)
+    order[k] = k;
+  std::stable_sort(order.begin(), order.end(), [&](unsigned x, unsigned y){
+    return ruleCounts(rules[x]) < ruleCounts(rules[y]);
+  });
+
+  LifeEnsemble ensemble(rules.size(), board.getRows(), board.getCols());
+  ensemble.loadBoardAll(board);
+  ensemble.setHaltAll(ehEmpty | ehStable | ehPeriod2 | ehPeriod, max_gens);
+  for(unsigned b = 0; b < order.size(); ++b)
+    ensemble.setRule(b, rules[order[b]]);
+
+  ensemble.run(max_gens, pool);
+
+  std::vector<SurveyResult> results(rules.size());
+  for(unsigned b = 0; b < order.size(); ++b){
+    SurveyResult& result = results[order[b]];
+    EnsembleHalt reason = ensemble.getHaltReason(b);
+
+    result.rule = rules[order[b]];
+    result.period = ensemble.getHaltPeriod(b);
+    result.population = ensemble.population(b);
+    result.generations = ensemble.getHaltGeneration(b);
+
+    if(reason == ehEmpty)
+      result.growth = gcDies;
+    else if(reason == ehStable)
+      result.growth = gcStable;
+    else if(reason == ehPeriod2 || reason == ehPeriod)
+      result.growth = gcPeriodic;
+    else
+      result.growth = touchesEdge(ensemble, b) ? gcGrows : gcChaotic;
+  }
+  return results;
+}
+
+std::string growthClassName(GrowthClass growth){
+  switch(growth){
+    case gcDies:
+      return "dies";
+    case gcStable:
+      return "stable";
+    case gcPeriodic:
+      return "periodic";
+    case gcChaotic:
+      return "chaotic";
+    default:
+      return "grows";
+  }
+}
+
+// "all", a file with a rule on each line, or rules separated by commas
+static std::vector<BSRule> parseRules(std::string val){
+  std::vector<BSRule> rules;
+
+  if(val == "all"){
+    for(unsigned index = 0; index < BS_RULE_COUNT; ++index)
+      rules.push_back(ruleFromIndex(index));
+    return rules;
+  }
+
+  std::ifstream infile(val.c_str());
+  std::stringstream list;
+  char separator = ',';
+  if(infile.good()){
+    list << infile.rdbuf();
+    separator = '\n';
+  }
+  else
+    list << val;
+
+  std::string text;
+  while(getline(list, text, separator)){
+    if(!text.empty() && text[text.size() - 1] == '\r')
+      text.erase(text.size() - 1);
+    if(text.empty() || text[0] == '#')
+      continue;
+
+    BSRule rule;
+    if(!parseRule(text, &rule))
+      Error("Bad rule: " + text);
+    rules.push_back(rule);
+  }
+
+  if(rules.empty())
+    Error("No rules in " + val);
+  return rules;
+}
+
+static void printUsage(const char* prog){
+  std::cerr << "usage: " << prog << " survey [options]\n"
+            << "  --rules <all|file|list>      rules to run, e.g. B36/S23,B3/S12 (default all)\n"
+            << "  --pattern <file>             board to start from (default: a random soup)\n"
+            << "  --soup <n>                   side of the random soup (default 16)\n"
+            << "  --seed <n>                   seed the soup is drawn from (default 1)\n"
+            << "  --size <n>                   side of the board (default 32)\n"
+            << "  --gens <n>                   generation limit of each rule (default 256)\n"
+            << "  --threads <n>                stepping threads (default: all cores)\n"
+            << "  --out <file>                 write every rule's result here as CSV\n";
+}
+
+int runSurvey(int argc, char* argv[]){
+  unsigned long long soup = 16, seed = 1, size = 32, gens = 256;
+  unsigned threads = std::thread::hardware_concurrency();
+  std::string rules_val = "all", pattern_file, out_file;
+
+  for(int i = 2; i < argc; ++i){
+    std::string opt = argv[i];
+
+    if(i + 1 >= argc){
+      std::cerr << "Missing value for " << opt << std::endl;
+      printUsage(argv[0]);
+      return 1;
+    }
+    std::string val = argv[++i];
+
+    if(opt == "--rules")
+      rules_val = val;
+    else if(opt == "--pattern")
+      pattern_file = val;
+    else if(opt == "--soup")
+      soup = parseCount(opt, val);
+    else if(opt == "--seed")
+      seed = parseCount(opt, val);
+    else if(opt == "--size")
+      size = parseCount(opt, val);
+    else if(opt == "--gens")
+      gens = parseCount(opt, val);
+    else if(opt == "--threads")
+      threads = parseCount(opt, val);
+    else if(opt == "--out")
+      out_file = val;
+    else{
+      std::cerr << "Unknown option " << opt << std::endl;
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  if(threads == 0)
+    threads = 1;
+  if(size == 0 || gens == 0)
+    Error("The board size and generation limit must be above 0");
+
+  std::vector<BSRule> rules = parseRules(rules_val);
+
+  LifeBoard board(size, size);
+  std::string start;
+  if(!pattern_file.empty()){
+    readPattern(pattern_file, board);
+    start = pattern_file;
+  }
+  else{
+    if(soup > size)
+      Error("The soup doesn't fit on the board");
+
+    uint64_t state = seed, bits = 0;
+    unsigned offset = (size - soup) / 2;
+    for(unsigned i = 0; i < soup; ++i){
+      for(unsigned j = 0; j < soup; ++j){
+        if(j % 64 == 0)
+          bits = splitMix64(&state);
+        board.setCell(offset + i, offset + j, (bits >> (j % 64)) & 1);
+      }
+    }
+    start = std::to_string(soup) + "x" + std::to_string(soup) + " soup (seed " +
+            std::to_string(seed) + ")";
+  }
+
+  unsigned shapes = 0;
+  std::vector<bool> seen(512, false);
+  for(size_t k = 0; k < rules.size(); ++k){
+    if(!seen[ruleCounts(rules[k])]){
+      seen[ruleCounts(rules[k])] = true;
+      ++shapes;
+    }
+  }
+
+  WorkerPool pool(threads);
+  Timer run_timer;
+  run_timer.Start();
+  std::vector<SurveyResult> results = surveyRules(board, rules, gens, &pool);
+  double elapsed = run_timer.GetDuration();
+
+  unsigned long long classes[5] = {0, 0, 0, 0, 0};
+  unsigned long long board_gens = 0;
+  size_t longest = 0;
+  for(size_t k = 0; k < results.size(); ++k){
+    ++classes[results[k].growth];
+    board_gens += results[k].generations;
+    if(results[k].period > results[longest].period)
+      longest = k;
+  }
+
+  if(!out_file.empty()){
+    std::ofstream outfile(out_file.c_str(), std::ios::out|std::ios::trunc);
+    if(outfile.fail())
+      Error("Couldn't open survey file " + out_file);
+    outfile << "rule,class,period,population,generations\n";
+    for(size_t k = 0; k < results.size(); ++k){
+      outfile << ruleName(results[k].rule) << "," << growthClassName(results[k].growth) << ","
+              << results[k].period << "," << results[k].population << ","
+              << results[k].generations << "\n";
+    }
+  }
+
+  std::cout << "start:        " << start << " on " << board.getRows() << "x" << board.getCols() << "\n"
+            << "rules:        " << rules.size() << " in " << shapes << " kernel shapes\n"
+            << "threads:      " << pool.getNumThreads() << "\n"
+            << "generations:  " << gens << " at most\n"
+            << "classes:      " << classes[gcDies] << " die, " << classes[gcStable] << " stable, "
+            << classes[gcPeriodic] << " periodic, " << classes[gcChaotic] << " chaotic, "
+            << classes[gcGrows] << " grow\n"
+            << "longest:      period " << results[longest].period << " ("
+            << ruleName(results[longest].rule) << ")\n"
+            << "elapsed:      " << elapsed << " s\n";
+
+  if(elapsed > 0){
+    std::cout << "rules/s:      " << rules.size() / elapsed << "\n"
+              << "board gens/s: " << board_gens / elapsed << "\n";
+  }
+
+  return 0;
+}
+
+#endif
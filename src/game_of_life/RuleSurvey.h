@@ -0,0 +1,41 @@
+#ifndef _RULE_SURVEY_H
+#define _RULE_SURVEY_H
+
+#include <string>
+#include <vector>
+#include "BSRule.h"
+#include "LifeBoard.h"
+#include "private/WorkerPool.h"
+
+// How a board ended up under a rule
+enum GrowthClass{
+  gcDies,         // every cell died
+  gcStable,       // stopped changing
+  gcPeriodic,     // repeats with a period above 1
+  gcChaotic,      // still going at the limit, away from the edges
+  gcGrows         // still going at the limit and reached an edge
+};
+
+struct SurveyResult {
+  BSRule rule;
+  GrowthClass growth;
+  unsigned long long period;        // 0 unless stable or periodic
+  unsigned long long population;    // when it stopped
+  unsigned long long generations;   // it ran for
+};
+
+// Runs the board under each rule for at most max_gens generations, on
+// a flat board of its size, and returns the results in the rules'
+// order. Every rule gets a board of an ensemble, placed so rules that
+// use the same neighbor counts share lane groups.
+std::vector<SurveyResult> surveyRules(const LifeBoard& board, const std::vector<BSRule>& rules,
+                                      unsigned long long max_gens, WorkerPool* pool = nullptr);
+
+// "dies", "stable", "periodic", "chaotic" or "grows"
+std::string growthClassName(GrowthClass growth);
+
+// "survey" followed by its options runs one board under many rules
+// and reports how each one ended. Returns the exit code.
+int runSurvey(int argc, char* argv[]);
+
+#endif
@@ -0,0 +1,105 @@
+/*
+ *  Author: Abraham Cardenas / https://github.com/Abe-Crdns
+ */
+
+#ifndef _SNAPSHOT_CPP
+#define _SNAPSHOT_CPP
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "../lpc_lib/lpclib.h"
+#include "Snapshot.h"
+
+// Largest single write, big enough to stay sequential without asking
+// the kernel for one multi-gigabyte transfer
+static const size_t WRITE_CHUNK_SIZE = 64 << 20;
+
+static void writeAll(int fd, const char* data, size_t size, std::string filename){
+  while(size > 0){
+    ssize_t written = write(fd, data, size < WRITE_CHUNK_SIZE ? size : WRITE_CHUNK_SIZE);
+    if(written <= 0){
+      close(fd);
+      Error("Couldn't write snapshot file " + filename);
+    }
+    data += written;
+    size -= written;
+  }
+}
+
+void readSnapshot(std::string filename, LifeBoard& board){
+  int fd = open(filename.c_str(), O_RDONLY);
+  if(fd < 0)
+    Error("Couldn't open snapshot file " + filename);
+
+  SnapshotHeader header;
+  struct stat file_stat;
+
+  if(fstat(fd, &file_stat) != 0 ||
+     pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+     memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0){
+    close(fd);
+    Error("Improperly formed snapshot file " + filename);
+  }
+
+  size_t rows_size = sizeof(uint64_t) * header.rows * header.row_words;
+
+  if(header.version != SNAPSHOT_VERSION || header.bound_scheme > Mirror ||
+     header.rows == 0 || header.cols == 0 ||
+     header.row_words != LifeBoard::rowWordsFor(header.cols) ||
+     (size_t)file_stat.st_size < sizeof(header) + rows_size){
+    close(fd);
+    Error("Improperly formed snapshot file " + filename);
+  }
+
+  if(header.birth != SNAPSHOT_BIRTH_B3 || header.survive != SNAPSHOT_SURVIVE_S23){
+    close(fd);
+    Error("Unsupported rule in snapshot file " + filename);
+  }
+
+  // private so stepping and edits never write back to the file
+  size_t map_size = sizeof(header) + rows_size;
+  void* map = mmap(nullptr, map_size, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(map == MAP_FAILED)
+    Error("Couldn't map snapshot file " + filename);
+
+  board.adoptMapping(map, map_size, sizeof(header), header.rows, header.cols);
+  board.setBoundScheme((BoundaryScheme)header.bound_scheme);
+  board.setGeneration(header.generation);
+}
+
+void writeSnapshot(std::string filename, const LifeBoard& board){
+  // written aside and renamed, the board may still be mapped from the
+  // file being replaced
+  std::string temp_file = filename + ".tmp";
+  int fd = open(temp_file.c_str(), O_WRONLY|O_CREAT|O_TRUNC, 0644);
+  if(fd < 0)
+    Error("Couldn't open snapshot file " + temp_file);
+
+  SnapshotHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+  header.version = SNAPSHOT_VERSION;
+  header.rows = board.getRows();
+  header.cols = board.getCols();
+  header.row_words = board.getRowWords();
+  header.bound_scheme = board.getBoundScheme();
+  header.birth = SNAPSHOT_BIRTH_B3;
+  header.survive = SNAPSHOT_SURVIVE_S23;
+  header.generation = board.getGeneration();
+
+  writeAll(fd, (const char*)&header, sizeof(header), temp_file);
+  if(board.getRows() > 0 && board.getCols() > 0){
+    writeAll(fd, (const char*)board.getRow(0),
+             sizeof(uint64_t) * board.getRows() * board.getRowWords(), temp_file);
+  }
+
+  if(close(fd) != 0 || rename(temp_file.c_str(), filename.c_str()) != 0)
+    Error("Couldn't write snapshot file " + filename);
+}
+
+#endif
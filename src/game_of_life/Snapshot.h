@@ -0,0 +1,44 @@
+#ifndef _SNAPSHOT_H
+#define _SNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include "LifeBoard.h"
+
+#define SNAPSHOT_MAGIC "GOLSNAP"
+#define SNAPSHOT_VERSION 1
+
+// B3/S23, bit n is set when n neighbors give birth (or survival)
+#define SNAPSHOT_BIRTH_B3 (1 << 3)
+#define SNAPSHOT_SURVIVE_S23 ((1 << 2) | (1 << 3))
+
+// Fixed header of a snapshot (.snap) file, in host byte order. The
+// board's rows follow it exactly as LifeBoard keeps them in memory,
+// padding included, so they start on a 64-byte boundary both in the
+// file and in a mapping of it.
+struct SnapshotHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t rows;
+  uint32_t cols;
+  uint32_t row_words;
+  uint32_t bound_scheme;
+  uint16_t birth;
+  uint16_t survive;
+  uint64_t generation;
+  uint8_t reserved[24];
+};
+
+static_assert(sizeof(SnapshotHeader) == 64, "snapshot rows must start on a 64-byte boundary");
+
+// Maps the snapshot and uses it in place as the board's current
+// generation, its size, generation and boundary scheme included.
+// Nothing is read past the header until the rows are touched.
+void readSnapshot(std::string filename, LifeBoard& board);
+
+// Writes the header and then every row in one sequential pass to
+// <file>.tmp, then renames it over the file, so a board still mapped
+// from the old snapshot can be written back to the same path
+void writeSnapshot(std::string filename, const LifeBoard& board);
+
+#endif
@@ -0,0 +1,361 @@
+/*
+ *  Author: Abraham Cardenas / https://github.com/Abe-Crdns
+ */
+
+#ifndef _SOUP_CENSUS_CPP
+#define _SOUP_CENSUS_CPP
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include "../lpc_lib/lpclib.h"
+#include "BatchRun.h"
+#include "SoupCensus.h"
+#include "private/SplitMix.h"
+#include "private/Timer.h"
+#include "private/WorkerPool.h"
+
+// Soups handed out to a thread at a time
+static const unsigned long long SOUPS_PER_CHUNK = 16;
+
+SoupRunner::SoupRunner(unsigned long long _max_gens, unsigned _side)
+  : board(_side, _side), phase_union(_side, _side), visited(_side * _side, 0){
+  max_gens = _max_gens;
+  side = _side;
+  edge_debris = false;
+}
+
+LifeBoard& SoupRunner::getBoard(){
+  return board;
+}
+
+void SoupRunner::placeSoup(unsigned long long seed, unsigned long long index){
+  uint64_t state = seed ^ (index * 0xD1B54A32D192ED03ULL);
+  unsigned top = (side - SOUP_SIDE) / 2;
+  unsigned left = (side - SOUP_SIDE) / 2;
+
+  board.clear();
+  board.setGeneration(0);
+
+  // each draw is four 16-cell rows
+  for(unsigned i = 0; i < SOUP_SIDE; i += 4){
+    uint64_t bits = splitMix64(&state);
+    for(unsigned r = 0; r < 4; ++r){
+      uint64_t row_bits = (bits >> (16 * r)) & 0xFFFF;
+      board.getRow(top + i + r)[left / 64] |= row_bits << (left % 64);
+    }
+  }
+}
+
+uint64_t SoupRunner::boardHash() const{
+  uint64_t hash = 0;
+  for(unsigned i = 0; i < board.getRows(); ++i){
+    const uint64_t* row = board.getRow(i);
+    // the shift carries high bits back down so no change can cancel out
+    for(unsigned k = 0; k < board.getUsedWords(); ++k){
+      hash = (hash ^ row[k]) * 0x9E3779B97F4A7C15ULL;
+      hash ^= hash >> 32;
+    }
+  }
+  return hash;
+}
+
+// The 8-connected live cells of cells reachable from (row, col)
+CellList SoupRunner::component(const LifeBoard& cells, unsigned row, unsigned col){
+  CellList found;
+  std::vector<std::pair<int, int> > pending(1, std::make_pair((int)row, (int)col));
+  visited[(row * side) + col] = 1;
+
+  while(!pending.empty()){
+    std::pair<int, int> cell = pending.back();
+    pending.pop_back();
+    found.push_back(cell);
+
+    for(int dr = -1; dr <= 1; ++dr){
+      for(int dc = -1; dc <= 1; ++dc){
+        int r = cell.first + dr, c = cell.second + dc;
+        if(r < 0 || c < 0 || r >= (int)side || c >= (int)side ||
+           visited[(r * side) + c] || !cells.getCell(r, c))
+          continue;
+        visited[(r * side) + c] = 1;
+        pending.push_back(std::make_pair(r, c));
+      }
+    }
+  }
+
+  return found;
+}
+
+// Tallies and erases spaceships near the edge before they hit it and
+// turn into debris that was never part of the soup's ash, and notes
+// anything else that's got that close
+void SoupRunner::removeEscapees(Census& census){
+  std::vector<CellList> ships;
+
+  for(unsigned i = 0; i < side; ++i){
+    bool whole_row = (i < ESCAPE_MARGIN || i >= side - ESCAPE_MARGIN);
+
+    for(unsigned j = board.nextCell(i, 0); j < side; j = board.nextCell(i, j + 1)){
+      if(!whole_row && j >= ESCAPE_MARGIN && j < side - ESCAPE_MARGIN){
+        j = board.nextCell(i, side - ESCAPE_MARGIN) - 1;
+        continue;
+      }
+      if(visited[(i * side) + j])
+        continue;
+
+      CellList cells = component(board, i, j);
+      std::vector<CellList> phases;
+      unsigned period;
+      int drow, dcol;
+
+      if(findPeriod(cells, MAX_SHIP_PERIOD, &period, &drow, &dcol, &phases) &&
+         (drow != 0 || dcol != 0)){
+        ++census[objectCode(phases, true)];
+        ships.push_back(cells);
+      }
+      else
+        edge_debris = true;
+    }
+  }
+
+  for(size_t s = 0; s < ships.size(); ++s){
+    for(size_t i = 0; i < ships[s].size(); ++i)
+      board.setCell(ships[s][i].first, ships[s][i].second, false);
+  }
+  std::fill(visited.begin(), visited.end(), 0);
+}
+
+// Splits the settled board into objects and tallies them. Cells are
+// grouped by the union of every phase, so an oscillator's parts stay
+// together; groups that don't behave the same on their own are merged
+// with any other such group within two cells and tried again. What
+// still doesn't is usually debris leaning on the board's edge.
+void SoupRunner::tallyAsh(unsigned period, Census& census){
+  phase_union = board;
+  for(unsigned p = 1; p < period; ++p){
+    board.step();
+    phase_union.stamp(board, 0, 0);
+  }
+  board.step();
+
+  std::vector<CellList> failed, failed_groups;
+  for(unsigned i = 0; i < side; ++i){
+    for(unsigned j = phase_union.nextCell(i, 0); j < side;
+        j = phase_union.nextCell(i, j + 1)){
+      if(visited[(i * side) + j])
+        continue;
+
+      CellList group = component(phase_union, i, j);
+      CellList cells;
+      for(size_t k = 0; k < group.size(); ++k){
+        if(board.getCell(group[k].first, group[k].second))
+          cells.push_back(group[k]);
+      }
+
+      std::vector<CellList> phases;
+      unsigned obj_period;
+      int drow, dcol;
+      if(findPeriod(cells, period, &obj_period, &drow, &dcol, &phases) &&
+         drow == 0 && dcol == 0 && period % obj_period == 0)
+        ++census[objectCode(phases, false)];
+      else{
+        failed.push_back(cells);
+        failed_groups.push_back(group);
+      }
+    }
+  }
+  std::fill(visited.begin(), visited.end(), 0);
+
+  // few and small, so comparing every pair of cells is fine. Each
+  // group's cells in any phase count towards being near.
+  std::vector<unsigned> parent(failed.size());
+  for(unsigned a = 0; a < failed.size(); ++a)
+    parent[a] = a;
+
+  for(unsigned a = 0; a < failed.size(); ++a){
+    for(unsigned b = a + 1; b < failed.size(); ++b){
+      const CellList& group_a = failed_groups[a];
+      const CellList& group_b = failed_groups[b];
+      bool near = false;
+      for(size_t i = 0; i < group_a.size() && !near; ++i){
+        for(size_t k = 0; k < group_b.size() && !near; ++k){
+          near = abs(group_a[i].first - group_b[k].first) <= 2 &&
+                 abs(group_a[i].second - group_b[k].second) <= 2;
+        }
+      }
+      if(!near)
+        continue;
+
+      unsigned ra = a, rb = b;
+      while(parent[ra] != ra) ra = parent[ra];
+      while(parent[rb] != rb) rb = parent[rb];
+      parent[rb] = ra;
+    }
+  }
+
+  for(unsigned a = 0; a < failed.size(); ++a){
+    if(parent[a] != a)
+      continue;
+
+    CellList cells;
+    for(unsigned b = 0; b < failed.size(); ++b){
+      unsigned root = b;
+      while(parent[root] != root) root = parent[root];
+      if(root == a)
+        cells.insert(cells.end(), failed[b].begin(), failed[b].end());
+    }
+
+    std::vector<CellList> phases;
+    unsigned obj_period;
+    int drow, dcol;
+    if(findPeriod(cells, period, &obj_period, &drow, &dcol, &phases) &&
+       drow == 0 && dcol == 0 && period % obj_period == 0)
+      ++census[objectCode(phases, false)];
+    else
+      ++census["zz_UNRESOLVED"];
+  }
+}
+
+bool SoupRunner::reachedEdge() const{
+  return edge_debris;
+}
+
+bool SoupRunner::run(unsigned long long seed, unsigned long long index, Census& census){
+  placeSoup(seed, index);
+  return settle(census);
+}
+
+bool SoupRunner::settle(Census& census){
+  seen.clear();
+  edge_debris = false;
+
+  for(unsigned long long gen = 0; gen <= max_gens; ++gen){
+    if(gen % ESCAPE_CHECK_GENS == 0)
+      removeEscapees(census);
+
+    std::pair<std::unordered_map<uint64_t, unsigned long long>::iterator, bool> entry =
+      seen.insert(std::make_pair(boardHash(), gen));
+    if(!entry.second){
+      tallyAsh(gen - entry.first->second, census);
+      return true;
+    }
+
+    board.step();
+  }
+
+  return false;
+}
+
+static void printUsage(const char* prog){
+  std::cerr << "usage: " << prog << " census [options]\n"
+            << "  --soups <n>                  soups to run (default 1000)\n"
+            << "  --seed <n>                   seed the soups are drawn from (default 1)\n"
+            << "  --threads <n>                soup threads (default: all cores)\n"
+            << "  --max-gens <n>               give up on a soup after this long (default 50000)\n"
+            << "  --out <file>                 write every object's count here as CSV\n";
+}
+
+int runCensus(int argc, char* argv[]){
+  unsigned long long soups = 1000, seed = 1, max_gens = 50000;
+  unsigned threads = std::thread::hardware_concurrency();
+  std::string out_file;
+
+  for(int i = 2; i < argc; ++i){
+    std::string opt = argv[i];
+
+    if(i + 1 >= argc){
+      std::cerr << "Missing value for " << opt << std::endl;
+      printUsage(argv[0]);
+      return 1;
+    }
+    std::string val = argv[++i];
+
+    if(opt == "--soups")
+      soups = parseCount(opt, val);
+    else if(opt == "--seed")
+      seed = parseCount(opt, val);
+    else if(opt == "--threads")
+      threads = parseCount(opt, val);
+    else if(opt == "--max-gens")
+      max_gens = parseCount(opt, val);
+    else if(opt == "--out")
+      out_file = val;
+    else{
+      std::cerr << "Unknown option " << opt << std::endl;
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+
+  if(threads == 0)
+    threads = 1;
+
+  // one census per thread, merged once they're all done
+  WorkerPool pool(threads);
+  std::vector<Census> censuses(threads);
+  std::vector<unsigned long long> unsettled(threads, 0);
+  std::atomic<unsigned long long> next_soup(0);
+  Timer run_timer;
+
+  run_timer.Start();
+  pool.run(threads, [&](unsigned t){
+    SoupRunner runner(max_gens);
+    unsigned long long first;
+    while((first = next_soup.fetch_add(SOUPS_PER_CHUNK)) < soups){
+      unsigned long long last = std::min(first + SOUPS_PER_CHUNK, soups);
+      for(unsigned long long index = first; index < last; ++index){
+        if(!runner.run(seed, index, censuses[t]))
+          ++unsettled[t];
+      }
+    }
+  });
+  double elapsed = run_timer.GetDuration();
+
+  Census total;
+  unsigned long long total_unsettled = 0, total_objects = 0;
+  for(unsigned t = 0; t < threads; ++t){
+    for(Census::const_iterator it = censuses[t].begin(); it != censuses[t].end(); ++it)
+      total[it->first] += it->second;
+    total_unsettled += unsettled[t];
+  }
+
+  std::vector<std::pair<unsigned long long, std::string> > ranked;
+  for(Census::const_iterator it = total.begin(); it != total.end(); ++it){
+    ranked.push_back(std::make_pair(it->second, it->first));
+    total_objects += it->second;
+  }
+  std::sort(ranked.begin(), ranked.end(),
+            [](const std::pair<unsigned long long, std::string>& a,
+               const std::pair<unsigned long long, std::string>& b){
+              return a.first != b.first ? a.first > b.first : a.second < b.second;
+            });
+
+  if(!out_file.empty()){
+    std::ofstream outfile(out_file.c_str(), std::ios::out|std::ios::trunc);
+    if(outfile.fail())
+      Error("Couldn't open census file " + out_file);
+    outfile << "object,count\n";
+    for(size_t i = 0; i < ranked.size(); ++i)
+      outfile << ranked[i].second << "," << ranked[i].first << "\n";
+  }
+
+  std::cout << "soups:        " << soups << " (seed " << seed << ")\n"
+            << "threads:      " << pool.getNumThreads() << "\n"
+            << "unsettled:    " << total_unsettled << "\n"
+            << "objects:      " << total_objects << " (" << ranked.size() << " distinct)\n"
+            << "elapsed:      " << elapsed << " s\n";
+
+  if(elapsed > 0){
+    std::cout << "soups/sec:    " << soups / elapsed << "\n"
+              << "per core:     " << soups / elapsed / pool.getNumThreads() << "\n";
+  }
+
+  for(size_t i = 0; i < ranked.size() && i < 10; ++i)
+    std::cout << "  " << ranked[i].second << "  " << ranked[i].first << "\n";
+
+  return 0;
+}
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef _SOUP_CENSUS_H
+#define _SOUP_CENSUS_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "LifeBoard.h"
+#include "ObjectCode.h"
+
+// Soups are SOUP_SIDE x SOUP_SIDE in the middle of a CENSUS_SIDE board
+#define SOUP_SIDE 16
+#define CENSUS_SIDE 256
+
+// Spaceships are looked for, and removed, this close to the edge
+// every ESCAPE_CHECK_GENS generations
+#define ESCAPE_MARGIN 8
+#define ESCAPE_CHECK_GENS 8
+#define MAX_SHIP_PERIOD 8
+
+// Object code -> how many were seen
+typedef std::unordered_map<std::string, unsigned long long> Census;
+
+// Runs soups to stability one after another, reusing its boards. Each
+// soup's cells come from its seed and index alone, so any soup can be
+// rerun on its own.
+class SoupRunner {
+  private:
+    LifeBoard board;
+    LifeBoard phase_union;
+    std::unordered_map<uint64_t, unsigned long long> seen;   // board hash -> generation
+    std::vector<uint8_t> visited;
+    unsigned long long max_gens;
+    unsigned side;
+    bool edge_debris;
+
+    uint64_t boardHash() const;
+    CellList component(const LifeBoard& cells, unsigned row, unsigned col);
+    void removeEscapees(Census& census);
+    void tallyAsh(unsigned period, Census& census);
+
+  public:
+    SoupRunner(unsigned long long _max_gens, unsigned _side = CENSUS_SIDE);
+
+    // The board settle() runs, for placing cells other than a soup
+    LifeBoard& getBoard();
+
+    // Fills the middle of the board with the soup's random cells
+    void placeSoup(unsigned long long seed, unsigned long long index);
+
+    // Runs the soup to stability and adds whatever it leaves behind,
+    // spaceships included, to the census. Returns false if it didn't
+    // settle within max_gens generations.
+    bool run(unsigned long long seed, unsigned long long index, Census& census);
+
+    // Same as run for whatever's on the board now
+    bool settle(Census& census);
+
+    // Whether anything but a spaceship came within ESCAPE_MARGIN of the
+    // edge during the last run or settle. It may have been cut off by
+    // the dead cells past the edge, so the census it added to may not
+    // be what it would have left on an unbounded plane.
+    bool reachedEdge() const;
+};
+
+// Headless census: "census" followed by its options runs seeded soups
+// across the cores and tallies the objects they settle into. Returns
+// the exit code.
+int runCensus(int argc, char* argv[]);
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ *  Author: Abraham Cardenas / https://github.com/Abe-Crdns
+ */
+
+#ifndef _SPECULATOR_CPP
+#define _SPECULATOR_CPP
+
+#include <algorithm>
+#include "Speculator.h"
+
+Speculator::Speculator(unsigned _max_gens){
+  max_gens = std::max(_max_gens, 1u);
+  active = false;
+  stopping = false;
+  epoch = 0;
+  worker = std::thread(&Speculator::workerLoop, this);
+}
+
+Speculator::~Speculator(){
+  {
+    std::lock_guard<std::mutex> lock(spec_mutex);
+    stopping = true;
+  }
+  has_room.notify_one();
+  worker.join();
+}
+
+void Speculator::start(const LifeBoard& board){
+  {
+    std::lock_guard<std::mutex> lock(spec_mutex);
+    base = board;
+    ready.clear();
+    active = true;
+    ++epoch;
+  }
+  has_room.notify_one();
+}
+
+void Speculator::cancel(){
+  std::lock_guard<std::mutex> lock(spec_mutex);
+  if(!active)
+    return;
+
+  ready.clear();
+  active = false;
+  ++epoch;
+}
+
+bool Speculator::isActive(){
+  std::lock_guard<std::mutex> lock(spec_mutex);
+  return active;
+}
+
+// Steps a board of its own, outside the lock, and hands over a copy of
+// each generation unless it was cancelled or restarted meanwhile
+void Speculator::workerLoop(){
+  LifeBoard working;
+  unsigned long long seeded = 0;
+  std::unique_lock<std::mutex> lock(spec_mutex);
+
+  while(true){
+    has_room.wait(lock, [this]{ return stopping || (active && ready.size() < max_gens); });
+    if(stopping)
+      return;
+
+    if(seeded != epoch){
+      working = base;
+      seeded = epoch;
+    }
+
+    lock.unlock();
+    working.step();
+    lock.lock();
+
+    if(seeded == epoch){
+      ready.push_back(working);
+      has_ready.notify_one();
+    }
+  }
+}
+
+bool Speculator::take(LifeBoard& board){
+  {
+    std::unique_lock<std::mutex> lock(spec_mutex);
+    if(!active)
+      return false;
+
+    // the worker has room, so it's already on the next one
+    has_ready.wait(lock, [this]{ return !ready.empty() || !active; });
+    if(!active)
+      return false;
+
+    if(ready.front().getGeneration() != board.getGeneration() + 1 ||
+       !board.advanceTo(ready.front())){
+      ready.clear();
+      active = false;
+      ++epoch;
+      return false;
+    }
+    ready.pop_front();
+  }
+  has_room.notify_one();
+  return true;
+}
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef _SPECULATOR_H
+#define _SPECULATOR_H
+
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "LifeBoard.h"
+
+// Generations computed ahead by default
+#define SPECULATE_GENS 32
+
+// Computes the generations after a board on a background thread, so
+// stepping it is just taking the next one. Once started from a board,
+// the worker keeps up to max_gens generations ready, topping them up
+// as they're taken. Anything else done to the board makes them wrong:
+// cancel drops them without waiting on the worker, which throws away
+// the generation it's on.
+class Speculator {
+  private:
+    unsigned max_gens;
+    LifeBoard base;                 // the board as started from
+    std::deque<LifeBoard> ready;    // the generations after it, in order
+    bool active;
+    bool stopping;
+    unsigned long long epoch;       // changes with every start and cancel
+
+    std::mutex spec_mutex;
+    std::condition_variable has_room;
+    std::condition_variable has_ready;
+    std::thread worker;
+
+    void workerLoop();
+
+  public:
+    Speculator(unsigned _max_gens = SPECULATE_GENS);
+    ~Speculator();
+
+    // Drops whatever was ready and speculates on from the board
+    void start(const LifeBoard& board);
+    void cancel();
+
+    // Whether generations after the board it was started from, or the
+    // last one taken, are being computed
+    bool isActive();
+
+    // Steps the board to the next generation if it's being speculated
+    // on, waiting for the worker if it's still on it. Returns false,
+    // leaving the board alone, if it isn't.
+    bool take(LifeBoard& board);
+};
+
+#endif
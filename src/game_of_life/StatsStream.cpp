@@ -0,0 +1,142 @@
+/*
+ *  Author: Abraham Cardenas / https://github.com/Abe-Crdns
+ */
+
+#ifndef _STATS_STREAM_CPP
+#define _STATS_STREAM_CPP
+
+#include "../lpc_lib/lpclib.h"
+#include "StatsStream.h"
+
+// Batch size handed to the writer at a time
+static const size_t STATS_BATCH_BYTES = 64 << 10;
+
+StatsStream::StatsStream(std::string filename, StatsFormat _format, bool _with_objects){
+  format = _format;
+  with_objects = _with_objects;
+  stopping = false;
+
+  if(filename == "-")
+    out = stdout;
+  else
+    out = fopen(filename.c_str(), format == sfBinary ? "wb" : "w");
+
+  if(out == nullptr)
+    Error("Couldn't open stats file " + filename);
+
+  if(format == sfCSV){
+    batch = "generation,population,births,deaths,top,left,bottom,right,active_tiles";
+    batch += with_objects ? ",still,oscillators,spaceships,unknown\n" : "\n";
+  }
+
+  writer = std::thread(&StatsStream::writerLoop, this);
+}
+
+StatsStream::~StatsStream(){
+  handOff();
+  {
+    std::lock_guard<std::mutex> lock(stream_mutex);
+    stopping = true;
+  }
+  has_data.notify_one();
+  writer.join();
+
+  if(out == stdout)
+    fflush(out);
+  else
+    fclose(out);
+}
+
+void StatsStream::handOff(){
+  if(batch.empty())
+    return;
+
+  {
+    std::unique_lock<std::mutex> lock(stream_mutex);
+    has_room.wait(lock, [this]{ return pending.size() < STATS_MAX_PENDING * STATS_BATCH_BYTES; });
+    if(pending.empty())
+      pending.swap(batch);
+    else
+      pending += batch;
+  }
+  batch.clear();
+  has_data.notify_one();
+}
+
+void StatsStream::writerLoop(){
+  std::string writing;
+
+  while(true){
+    {
+      std::unique_lock<std::mutex> lock(stream_mutex);
+      has_data.wait(lock, [this]{ return stopping || !pending.empty(); });
+      if(pending.empty())
+        return;
+      writing.swap(pending);
+    }
+    has_room.notify_one();
+
+    fwrite(writing.data(), 1, writing.size(), out);
+    writing.clear();
+  }
+}
+
+void StatsStream::write(unsigned long long generation, const StepStats& stats,
+                        const ObjectCounts* objects){
+  ObjectCounts none = { 0, 0, 0, 0 };
+  if(objects == nullptr)
+    objects = &none;
+
+  if(format == sfBinary){
+    StatsRecord record;
+    record.generation = generation;
+    record.population = stats.population;
+    record.births = stats.births;
+    record.deaths = stats.deaths;
+    record.active_tiles = stats.active_tiles;
+    record.top = stats.empty ? STATS_NO_BOUNDS : stats.top;
+    record.left = stats.empty ? STATS_NO_BOUNDS : stats.left;
+    record.bottom = stats.empty ? STATS_NO_BOUNDS : stats.bottom;
+    record.right = stats.empty ? STATS_NO_BOUNDS : stats.right;
+    batch.append((const char*)&record, sizeof(record));
+
+    if(with_objects){
+      StatsObjectsRecord counts;
+      counts.still = objects->still;
+      counts.oscillators = objects->oscillators;
+      counts.spaceships = objects->spaceships;
+      counts.unknown = objects->unknown;
+      batch.append((const char*)&counts, sizeof(counts));
+    }
+  }
+  else{
+    char line[256];
+    int len;
+
+    // an empty board has no bounds, those columns are left blank
+    if(stats.empty){
+      len = snprintf(line, sizeof(line), "%llu,%llu,%llu,%llu,,,,,%llu\n",
+                     generation, stats.population, stats.births, stats.deaths,
+                     stats.active_tiles);
+    }
+    else{
+      len = snprintf(line, sizeof(line), "%llu,%llu,%llu,%llu,%u,%u,%u,%u,%llu\n",
+                     generation, stats.population, stats.births, stats.deaths,
+                     stats.top, stats.left, stats.bottom, stats.right,
+                     stats.active_tiles);
+    }
+
+    // the counts go in place of the newline
+    if(with_objects){
+      len += snprintf(line + len - 1, sizeof(line) - len + 1, ",%llu,%llu,%llu,%llu\n",
+                      objects->still, objects->oscillators, objects->spaceships,
+                      objects->unknown) - 1;
+    }
+    batch.append(line, len);
+  }
+
+  if(batch.size() >= STATS_BATCH_BYTES)
+    handOff();
+}
+
+#endif
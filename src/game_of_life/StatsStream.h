@@ -0,0 +1,74 @@
+#ifndef _STATS_STREAM_H
+#define _STATS_STREAM_H
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "LifeBoard.h"
+#include "ObjectTracker.h"
+
+enum StatsFormat{
+  sfCSV, sfBinary
+};
+
+// Batches that can wait for the writer before stepping waits too
+#define STATS_MAX_PENDING 4
+
+// Bounds of an empty board in the binary format
+#define STATS_NO_BOUNDS 0xFFFFFFFF
+
+// One generation in the binary format, host byte order
+struct StatsRecord {
+  uint64_t generation;
+  uint64_t population;
+  uint64_t births;
+  uint64_t deaths;
+  uint64_t active_tiles;
+  uint32_t top, left, bottom, right;
+};
+
+// Follows each record when objects are tracked
+struct StatsObjectsRecord {
+  uint64_t still;
+  uint64_t oscillators;
+  uint64_t spaceships;
+  uint64_t unknown;
+};
+
+// Per-generation statistics written to a file or pipe ("-" for stdout).
+// Records are batched in memory and handed to a writer thread, so a
+// slow reader on the other end doesn't hold up stepping until
+// STATS_MAX_PENDING batches are waiting for it. Past that, stepping
+// waits for the writer to catch up: no line is dropped, and memory
+// stays bounded however slow the reader is.
+class StatsStream {
+  private:
+    FILE* out;
+    StatsFormat format;
+    bool with_objects;
+
+    std::string batch;      // only touched by the stepping thread
+    std::string pending;    // batches waiting for the writer
+    std::mutex stream_mutex;
+    std::condition_variable has_data;
+    std::condition_variable has_room;
+    std::thread writer;
+    bool stopping;
+
+    void handOff();
+    void writerLoop();
+
+  public:
+    // With _with_objects every generation also has the tracker's
+    // object counts
+    StatsStream(std::string filename, StatsFormat _format = sfCSV, bool _with_objects = false);
+    ~StatsStream();
+
+    void write(unsigned long long generation, const StepStats& stats,
+               const ObjectCounts* objects = nullptr);
+};
+
+#endif
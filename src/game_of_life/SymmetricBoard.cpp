@@ -0,0 +1,172 @@
+/*
+ *  Author: Abraham Cardenas / https://github.com/Abe-Crdns
+ */
+
+#ifndef _SYMMETRIC_BOARD_CPP
+#define _SYMMETRIC_BOARD_CPP
+
+#include <cstring>
+#include <vector>
+#include "../lpc_lib/lpclib.h"
+#include "SymmetricBoard.h"
+
+static inline uint64_t reverseBits(uint64_t x){
+  x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+  x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+  x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+  return __builtin_bswap64(x);
+}
+
+// Writes the row's cols cells back to front into dest, a word at a
+// time: reversing every word and their order puts the last column at
+// the top of a whole number of words, so it's shifted back down
+static void reverseRow(const uint64_t* row, unsigned cols, uint64_t* dest){
+  unsigned words = (cols + 63) / 64;
+  unsigned shift = (words * 64) - cols;
+
+  for(unsigned k = 0; k < words; ++k)
+    dest[k] = reverseBits(row[words - 1 - k]);
+
+  if(shift == 0)
+    return;
+  for(unsigned k = 0; k < words; ++k)
+    dest[k] = (dest[k] >> shift) | (k + 1 < words ? dest[k + 1] << (64 - shift) : 0);
+}
+
+bool hasSymmetry(const LifeBoard& board, Symmetry symmetry){
+  unsigned rows = board.getRows(), cols = board.getCols();
+  unsigned words = board.getUsedWords();
+
+  if(symmetry & symLeftRight){
+    std::vector<uint64_t> reversed(words);
+    for(unsigned i = 0; i < rows; ++i){
+      reverseRow(board.getRow(i), cols, reversed.data());
+      if(memcmp(reversed.data(), board.getRow(i), words * sizeof(uint64_t)) != 0)
+        return false;
+    }
+  }
+
+  if(symmetry & symTopBottom){
+    for(unsigned i = 0; i < rows / 2; ++i){
+      if(memcmp(board.getRow(i), board.getRow(rows - 1 - i), words * sizeof(uint64_t)) != 0)
+        return false;
+    }
+  }
+
+  return true;
+}
+
+Symmetry detectSymmetry(const LifeBoard& board){
+  int found = symNone;
+  if(hasSymmetry(board, symLeftRight))
+    found |= symLeftRight;
+  if(hasSymmetry(board, symTopBottom))
+    found |= symTopBottom;
+  return (Symmetry)found;
+}
+
+std::string symmetryName(Symmetry symmetry){
+  switch(symmetry){
+    case symLeftRight:
+      return "lr";
+    case symTopBottom:
+      return "tb";
+    case symD4:
+      return "d4";
+    default:
+      return "none";
+  }
+}
+
+SymmetricBoard::SymmetricBoard(const LifeBoard& board, Symmetry _symmetry){
+  if(board.getBoundScheme() == Donut)
+    Error("A donut board can't be stepped by its symmetry");
+  if(!hasSymmetry(board, _symmetry))
+    Error("The board doesn't have " + symmetryName(_symmetry) + " symmetry");
+
+  rows = board.getRows();
+  cols = board.getCols();
+
+  // a single row or column has nothing to fold
+  int folds = _symmetry;
+  if(rows < 2)
+    folds &= ~symTopBottom;
+  if(cols < 2)
+    folds &= ~symLeftRight;
+  symmetry = (Symmetry)folds;
+
+  // on an odd board the middle row or column is the first real one
+  mirror_rows = (symmetry & symTopBottom) ? 1 : 0;
+  mirror_cols = (symmetry & symLeftRight) ? 1 : 0;
+  top = mirror_rows ? rows / 2 : 0;
+  left = mirror_cols ? cols / 2 : 0;
+
+  domain.setBoundScheme(board.getBoundScheme());
+  domain.resize(rows - top + mirror_rows, cols - left + mirror_cols);
+  domain.stamp(board, -(int)(top - mirror_rows), -(int)(left - mirror_cols));
+  domain.setGeneration(board.getGeneration());
+}
+
+Symmetry SymmetricBoard::getSymmetry() const{
+  return symmetry;
+}
+
+unsigned long long SymmetricBoard::getGeneration() const{
+  return domain.getGeneration();
+}
+
+double SymmetricBoard::getWorkFraction() const{
+  double whole = (double)rows * ((cols + 63) / 64);
+  return ((double)domain.getRows() * domain.getUsedWords()) / whole;
+}
+
+// The mirror column copies the column across the axis from it, the
+// mirror row likewise, and the corner comes along with the row
+void SymmetricBoard::refreshMirrors(){
+  if(mirror_cols){
+    unsigned source = 1 + (cols % 2);
+    for(unsigned i = 0; i < domain.getRows(); ++i){
+      uint64_t* row = domain.getRow(i);
+      row[0] = (row[0] & ~1ULL) | ((row[0] >> source) & 1);
+    }
+  }
+
+  if(mirror_rows){
+    unsigned source = 1 + (rows % 2);
+    memcpy(domain.getRow(0), domain.getRow(source), domain.getUsedWords() * sizeof(uint64_t));
+  }
+}
+
+void SymmetricBoard::step(WorkerPool* pool){
+  domain.step(pool);
+  refreshMirrors();
+}
+
+void SymmetricBoard::reconstruct(LifeBoard& board) const{
+  board.setBoundScheme(domain.getBoundScheme());
+  if(board.getRows() != rows || board.getCols() != cols)
+    board.resize(rows, cols);
+  else
+    board.clear();
+
+  // the mirror row and column land on cells that hold the same thing
+  int first_row = top - mirror_rows;
+  board.stamp(domain, first_row, left - mirror_cols);
+
+  if(mirror_cols){
+    std::vector<uint64_t> reversed(board.getUsedWords());
+    for(unsigned i = first_row; i < rows; ++i){
+      uint64_t* row = board.getRow(i);
+      reverseRow(row, cols, reversed.data());
+      for(unsigned k = 0; k < board.getUsedWords(); ++k)
+        row[k] |= reversed[k];
+    }
+  }
+
+  for(int i = 0; i < first_row; ++i)
+    memcpy(board.getRow(i), board.getRow(rows - 1 - i), board.getUsedWords() * sizeof(uint64_t));
+
+  board.setGeneration(domain.getGeneration());
+}
+
+#endif
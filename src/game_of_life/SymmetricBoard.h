@@ -0,0 +1,59 @@
+#ifndef _SYMMETRIC_BOARD_H
+#define _SYMMETRIC_BOARD_H
+
+#include <string>
+#include "LifeBoard.h"
+#include "private/WorkerPool.h"
+
+// Mirror symmetries about the middle of the board, as a mask. The
+// middle is between two rows or columns on an even board and through
+// one on an odd board.
+enum Symmetry{
+  symNone = 0,
+  symLeftRight = 1,     // each row reads the same backwards (D2, vertical axis)
+  symTopBottom = 2,     // the board reads the same upside down (D2, horizontal axis)
+  symD4 = 3             // both
+};
+
+// Every symmetry the board has
+Symmetry detectSymmetry(const LifeBoard& board);
+bool hasSymmetry(const LifeBoard& board, Symmetry symmetry);
+
+// "none", "lr", "tb" or "d4"
+std::string symmetryName(Symmetry symmetry);
+
+// A symmetric board stepped as its fundamental domain: the bottom
+// and/or right half, middle row or column included, with one more row
+// or column above and to the left of it holding the mirror image of
+// what's next to the axis. Life keeps the symmetry, so stepping that
+// and refreshing the mirror row and column after each step is the
+// same as stepping the whole board, for a half or a quarter of the
+// work. Only flat and mirror boards can be split this way.
+class SymmetricBoard {
+  private:
+    LifeBoard domain;
+    unsigned rows, cols;        // of the whole board
+    unsigned top, left;         // whole-board cell at the domain's first real cell
+    unsigned mirror_rows;       // 1 if the domain has a mirror row, else 0
+    unsigned mirror_cols;
+    Symmetry symmetry;
+
+    void refreshMirrors();
+
+  public:
+    // Takes over a copy of the board, which must have the symmetry
+    SymmetricBoard(const LifeBoard& board, Symmetry _symmetry);
+
+    Symmetry getSymmetry() const;
+    unsigned long long getGeneration() const;
+
+    // Words stepped per generation as a fraction of the whole board's
+    double getWorkFraction() const;
+
+    void step(WorkerPool* pool = nullptr);
+
+    // Writes out the whole board, for rendering or export
+    void reconstruct(LifeBoard& board) const;
+};
+
+#endif
@@ -15,7 +15,7 @@ Button::Button(Coords pos, std::string btnText, unsigned trimTextSize){
   position = pos;
   is_clicked = false;
 
-  GAME_WINDOW.DrawRectangle(
+  GAME_WINDOW->DrawRectangle(
     pos.x, pos.y, 
     BUTTON_WIDTH, BUTTON_HEIGHT, 
     GREY, true
@@ -24,7 +24,7 @@ Button::Button(Coords pos, std::string btnText, unsigned trimTextSize){
   if(trimTextSize > 0)
     btnText = btnText.substr(trimTextSize);
 
-  GAME_WINDOW.DrawString(
+  GAME_WINDOW->DrawString(
     btnText, 
     pos.x + 16, 
     pos.y + 3, 
@@ -49,14 +49,14 @@ void Button::click(){
   is_clicked = !is_clicked;
 
   if(is_clicked){
-    GAME_WINDOW.DrawRectangle(
+    GAME_WINDOW->DrawRectangle(
       position.x, position.y, 
       BUTTON_WIDTH, BUTTON_HEIGHT, 
       YELLOW, true
     );
   }
   else{
-    GAME_WINDOW.DrawRectangle(
+    GAME_WINDOW->DrawRectangle(
       position.x, position.y, 
       BUTTON_WIDTH, BUTTON_HEIGHT, 
       GREY, true
@@ -67,7 +67,7 @@ void Button::click(){
   if(trim_text_size > 0)
     btnText = btnText.substr(3);
 
-  GAME_WINDOW.DrawString(
+  GAME_WINDOW->DrawString(
     btnText, 
     position.x + 16, 
     position.y + 3, 
@@ -76,7 +76,7 @@ void Button::click(){
 }
 
 void Button::enable(){
-  GAME_WINDOW.DrawRectangle(
+  GAME_WINDOW->DrawRectangle(
     position.x, position.y, 
     BUTTON_WIDTH, BUTTON_HEIGHT, 
     GREY, true
@@ -86,7 +86,7 @@ void Button::enable(){
   if(trim_text_size > 0)
     btnText = btnText.substr(3);
 
-  GAME_WINDOW.DrawString(
+  GAME_WINDOW->DrawString(
     btnText, 
     position.x + 16, 
     position.y + 3, 
@@ -95,7 +95,7 @@ void Button::enable(){
 }
 
 void Button::disable(){
-  GAME_WINDOW.DrawRectangle(
+  GAME_WINDOW->DrawRectangle(
     position.x, position.y, 
     BUTTON_WIDTH, BUTTON_HEIGHT, 
     DARK_GREY, true
@@ -105,7 +105,7 @@ void Button::disable(){
   if(trim_text_size > 0)
     btnText = btnText.substr(3);
 
-  GAME_WINDOW.DrawString(
+  GAME_WINDOW->DrawString(
     btnText, 
     position.x + 16, 
     position.y + 3, 
@@ -0,0 +1,63 @@
+#ifndef _LIFE_RULE_H
+#define _LIFE_RULE_H
+
+#include <cstdint>
+
+// Bit-sliced neighbor count of 64 cells at a time: each argument holds
+// one neighbor (or the cell itself, b) of 64 independent cells. The
+// three horizontal neighbor sums are added as 2-bit numbers, giving
+// ones/twos/fours/eights planes of the neighbor count for every cell
+// in the word.
+static inline void countNeighbors(uint64_t aw, uint64_t a, uint64_t ae,
+                                  uint64_t bw, uint64_t be,
+                                  uint64_t cw, uint64_t c, uint64_t ce,
+                                  uint64_t* ones, uint64_t* twos,
+                                  uint64_t* fours, uint64_t* eights){
+  uint64_t a0 = aw ^ a ^ ae, a1 = (aw & a) | (ae & (aw ^ a));
+  uint64_t c0 = cw ^ c ^ ce, c1 = (cw & c) | (ce & (cw ^ c));
+  uint64_t b0 = bw ^ be, b1 = bw & be;
+
+  *ones = a0 ^ b0 ^ c0;
+  uint64_t ones_carry = (a0 & b0) | (c0 & (a0 ^ b0));
+  uint64_t x = a1 ^ b1 ^ c1;
+  uint64_t y = (a1 & b1) | (c1 & (a1 ^ b1));
+  *twos = x ^ ones_carry;
+  *fours = y ^ (x & ones_carry);
+  *eights = y & x & ones_carry;
+}
+
+// Bit-sliced B3/S23: bit i of the result is the next state of cell i
+static inline uint64_t lifeRule(uint64_t aw, uint64_t a, uint64_t ae,
+                                uint64_t bw, uint64_t b, uint64_t be,
+                                uint64_t cw, uint64_t c, uint64_t ce){
+  uint64_t ones, twos, fours, eights;
+  countNeighbors(aw, a, ae, bw, be, cw, c, ce, &ones, &twos, &fours, &eights);
+
+  // a count of 2 or 3 is the only one with twos set and fours
+  // clear, 10 and 11 can't happen with 8 neighbors
+  return twos & ~fours & (ones | b);
+}
+
+// Bit-sliced outer-totalistic rule, one per cell: bit i of birth[n]
+// (survive[n]) is set when cell i comes alive (stays alive) with n
+// neighbors. Only the neighbor counts in the counts mask are looked
+// at, the rest must be clear in every cell's rule.
+static inline uint64_t bsRule(uint64_t aw, uint64_t a, uint64_t ae,
+                              uint64_t bw, uint64_t b, uint64_t be,
+                              uint64_t cw, uint64_t c, uint64_t ce,
+                              const uint64_t* birth, const uint64_t* survive,
+                              unsigned counts){
+  uint64_t ones, twos, fours, eights;
+  countNeighbors(aw, a, ae, bw, be, cw, c, ce, &ones, &twos, &fours, &eights);
+
+  uint64_t result = 0;
+  for(; counts != 0; counts &= counts - 1){
+    unsigned n = __builtin_ctz(counts);
+    uint64_t match = ((n & 1) ? ones : ~ones) & ((n & 2) ? twos : ~twos) &
+                     ((n & 4) ? fours : ~fours) & ((n & 8) ? eights : ~eights);
+    result |= match & ((b & survive[n]) | (~b & birth[n]));
+  }
+  return result;
+}
+
+#endif
@@ -0,0 +1,205 @@
+/*
+ *  Author: Abraham Cardenas / https://github.com/Abe-Crdns
+ */
+
+#ifndef _QUAD_TREE_CPP
+#define _QUAD_TREE_CPP
+
+#include "QuadTree.h"
+
+bool QuadTree::BranchKey::operator==(const BranchKey& other) const{
+  return child[0] == other.child[0] && child[1] == other.child[1] &&
+         child[2] == other.child[2] && child[3] == other.child[3];
+}
+
+size_t QuadTree::BranchHash::operator()(const BranchKey& key) const{
+  uint64_t h = key.child[0];
+  for(unsigned i = 1; i < 4; ++i)
+    h = (h * 0x9E3779B97F4A7C15ULL) ^ key.child[i];
+  return h ^ (h >> 29);
+}
+
+QuadTree::QuadTree(){
+  Node empty = {0, 0, {0, 0, 0, 0}};
+  nodes.push_back(empty);
+}
+
+unsigned QuadTree::getNumNodes() const{
+  return nodes.size();
+}
+
+const QuadTree::Node& QuadTree::getNode(unsigned id) const{
+  return nodes[id];
+}
+
+unsigned QuadTree::makeLeaf(uint64_t bits){
+  if(bits == 0)
+    return 0;
+
+  std::unordered_map<uint64_t, unsigned>::iterator it = leaf_index.find(bits);
+  if(it != leaf_index.end())
+    return it->second;
+
+  Node leaf = {QUAD_LEAF_LEVEL, bits, {0, 0, 0, 0}};
+  nodes.push_back(leaf);
+  leaf_index[bits] = nodes.size() - 1;
+  return nodes.size() - 1;
+}
+
+unsigned QuadTree::makeBranch(unsigned level, unsigned nw, unsigned ne,
+                              unsigned sw, unsigned se){
+  if(nw == 0 && ne == 0 && sw == 0 && se == 0)
+    return 0;
+
+  // the children's level is implied by any non-empty one
+  BranchKey key = {{nw, ne, sw, se}};
+  std::unordered_map<BranchKey, unsigned, BranchHash>::iterator it = branch_index.find(key);
+  if(it != branch_index.end())
+    return it->second;
+
+  Node branch = {level, 0, {nw, ne, sw, se}};
+  nodes.push_back(branch);
+  branch_index[key] = nodes.size() - 1;
+  return nodes.size() - 1;
+}
+
+unsigned QuadTree::buildFrom(const LifeBoard& board, unsigned level,
+                             long long row, long long col){
+  if(row >= board.getRows() || col >= board.getCols())
+    return 0;
+
+  if(level == QUAD_LEAF_LEVEL){
+    unsigned word = col / 64;
+    unsigned shift = col % 64;
+    uint64_t bits = 0;
+
+    for(unsigned r = 0; r < 8 && row + r < board.getRows(); ++r){
+      const uint64_t* words = board.getRow(row + r);
+      uint64_t line = words[word] >> shift;
+      if(shift > 56 && word + 1 < board.getUsedWords())
+        line |= words[word + 1] << (64 - shift);
+      bits |= (line & 0xFF) << (8 * r);
+    }
+    return makeLeaf(bits);
+  }
+
+  long long half = 1LL << (level - 1);
+  unsigned nw = buildFrom(board, level - 1, row, col);
+  unsigned ne = buildFrom(board, level - 1, row, col + half);
+  unsigned sw = buildFrom(board, level - 1, row + half, col);
+  unsigned se = buildFrom(board, level - 1, row + half, col + half);
+  return makeBranch(level, nw, ne, sw, se);
+}
+
+unsigned QuadTree::fromBoard(const LifeBoard& board, unsigned* top, unsigned* left){
+  unsigned bottom, right;
+  if(!board.boundingBox(top, left, &bottom, &right))
+    return 0;
+
+  unsigned height = bottom - *top + 1;
+  unsigned width = right - *left + 1;
+  unsigned level = QUAD_LEAF_LEVEL;
+  while((1ULL << level) < height || (1ULL << level) < width)
+    ++level;
+
+  return buildFrom(board, level, *top, *left);
+}
+
+bool QuadTree::boundingBox(unsigned id, uint64_t* top, uint64_t* left,
+                           uint64_t* bottom, uint64_t* right) const{
+  if(id == 0)
+    return false;
+
+  // children always come before their parents, so one pass in id
+  // order visits each distinct node once
+  struct Box {
+    uint64_t top, left, bottom, right;
+  };
+  std::vector<Box> boxes(id + 1);
+
+  for(unsigned i = 1; i <= id; ++i){
+    const Node& node = nodes[i];
+    Box& box = boxes[i];
+
+    if(node.level == QUAD_LEAF_LEVEL){
+      box.top = box.left = 7;
+      box.bottom = box.right = 0;
+      for(unsigned r = 0; r < 8; ++r){
+        uint64_t line = (node.leaf >> (8 * r)) & 0xFF;
+        if(line == 0)
+          continue;
+        if(r < box.top) box.top = r;
+        if(r > box.bottom) box.bottom = r;
+        if((uint64_t)__builtin_ctzll(line) < box.left) box.left = __builtin_ctzll(line);
+        if((uint64_t)(63 - __builtin_clzll(line)) > box.right) box.right = 63 - __builtin_clzll(line);
+      }
+      continue;
+    }
+
+    uint64_t half = 1ULL << (node.level - 1);
+    bool found = false;
+    for(unsigned k = 0; k < 4; ++k){
+      if(node.child[k] == 0)
+        continue;
+
+      const Box& sub = boxes[node.child[k]];
+      uint64_t row_off = (k >= 2) ? half : 0;
+      uint64_t col_off = (k % 2 == 1) ? half : 0;
+
+      if(!found || sub.top + row_off < box.top) box.top = sub.top + row_off;
+      if(!found || sub.left + col_off < box.left) box.left = sub.left + col_off;
+      if(!found || sub.bottom + row_off > box.bottom) box.bottom = sub.bottom + row_off;
+      if(!found || sub.right + col_off > box.right) box.right = sub.right + col_off;
+      found = true;
+    }
+  }
+
+  *top = boxes[id].top;
+  *left = boxes[id].left;
+  *bottom = boxes[id].bottom;
+  *right = boxes[id].right;
+  return true;
+}
+
+void QuadTree::render(unsigned id, LifeBoard& board, long long row, long long col) const{
+  const Node& node = nodes[id];
+  long long size = 1LL << node.level;
+
+  if(id == 0 || row >= board.getRows() || col >= board.getCols() ||
+     row + size <= 0 || col + size <= 0)
+    return;
+
+  if(node.level == QUAD_LEAF_LEVEL){
+    for(unsigned r = 0; r < 8; ++r){
+      long long dest_row = row + r;
+      uint64_t bits = (node.leaf >> (8 * r)) & 0xFF;
+      if(bits == 0 || dest_row < 0 || dest_row >= board.getRows())
+        continue;
+
+      long long dest_col = col;
+      if(dest_col < 0){
+        bits >>= -dest_col;
+        dest_col = 0;
+      }
+      // keep the padding past the last column dead
+      if(dest_col + 8 > board.getCols())
+        bits &= (1ULL << (board.getCols() - dest_col)) - 1;
+
+      uint64_t* words = board.getRow(dest_row);
+      unsigned word = dest_col / 64;
+      unsigned shift = dest_col % 64;
+      words[word] |= bits << shift;
+      if(shift > 56 && word + 1 < board.getUsedWords())
+        words[word + 1] |= bits >> (64 - shift);
+    }
+    return;
+  }
+
+  long long half = size / 2;
+  render(node.child[0], board, row, col);
+  render(node.child[1], board, row, col + half);
+  render(node.child[2], board, row + half, col);
+  render(node.child[3], board, row + half, col + half);
+}
+
+#endif
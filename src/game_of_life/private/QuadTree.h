@@ -0,0 +1,67 @@
+#ifndef _QUAD_TREE_H
+#define _QUAD_TREE_H
+
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include "../LifeBoard.h"
+
+// Level of the 8x8 leaves
+#define QUAD_LEAF_LEVEL 3
+
+// Deepest level whose corners still fit in a long long
+#define QUAD_MAX_LEVEL 62
+
+// Hash-consed quadtree of a pattern. Identical subtrees are stored once,
+// so memory grows with the number of distinct nodes rather than with the
+// pattern's area. Node 0 is the empty node of every level.
+class QuadTree {
+  public:
+    struct Node {
+      unsigned level;     // the node covers 2^level x 2^level cells
+      uint64_t leaf;      // level 3 only, byte r is row r, bit c is column c
+      unsigned child[4];  // nw, ne, sw, se
+    };
+
+  private:
+    struct BranchKey {
+      unsigned child[4];
+      bool operator==(const BranchKey& other) const;
+    };
+    struct BranchHash {
+      size_t operator()(const BranchKey& key) const;
+    };
+
+    std::vector<Node> nodes;
+    std::unordered_map<uint64_t, unsigned> leaf_index;
+    std::unordered_map<BranchKey, unsigned, BranchHash> branch_index;
+
+    unsigned buildFrom(const LifeBoard& board, unsigned level,
+                       long long row, long long col);
+
+  public:
+    QuadTree();
+
+    unsigned getNumNodes() const;
+    const Node& getNode(unsigned id) const;
+
+    // Return the existing node if there is one
+    unsigned makeLeaf(uint64_t bits);
+    unsigned makeBranch(unsigned level, unsigned nw, unsigned ne,
+                        unsigned sw, unsigned se);
+
+    // Builds the smallest tree covering the board's live cells and returns
+    // its root. (top, left) is set to the board cell at the root's corner.
+    unsigned fromBoard(const LifeBoard& board, unsigned* top, unsigned* left);
+
+    // Live cell bounds relative to the node's top left corner, inclusive.
+    // Returns false if the node is empty.
+    bool boundingBox(unsigned id, uint64_t* top, uint64_t* left,
+                     uint64_t* bottom, uint64_t* right) const;
+
+    // ORs the node's live cells into the board with its top left corner
+    // at (row, col), clipping whatever falls off the board
+    void render(unsigned id, LifeBoard& board, long long row, long long col) const;
+};
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef _SPLIT_MIX_H
+#define _SPLIT_MIX_H
+
+#include <cstdint>
+
+// SplitMix64: fast, seedable and the same on every platform, so random
+// boards can be regenerated from their seed alone
+static inline uint64_t splitMix64(uint64_t* state){
+  uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+#endif
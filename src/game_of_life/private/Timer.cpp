@@ -4,7 +4,7 @@
 #include "Timer.h"
 
 void Timer::Start(){ 
-  m_tpStart = std::chrono::high_resolution_clock::now(); 
+  m_tpStart = std::chrono::steady_clock::now(); 
 }
 
 bool Timer::WasStarted(){ 
@@ -18,7 +18,7 @@ void Timer::Reset(){
 
 double Timer::GetDuration(){
   std::chrono::duration<double> duration = 
-    std::chrono::high_resolution_clock::now() - m_tpStart;
+    std::chrono::steady_clock::now() - m_tpStart;
 
   return duration.count();
 }
@@ -0,0 +1,95 @@
+/*
+ *  Author: Abraham Cardenas / https://github.com/Abe-Crdns
+ */
+
+#ifndef _WORKER_POOL_CPP
+#define _WORKER_POOL_CPP
+
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(unsigned num_threads){
+  num_tasks = 0;
+  next_task = 0;
+  tasks_done = 0;
+  batch = 0;
+  stopping = false;
+
+  // the calling thread is the first worker
+  for(unsigned i = 1; i < num_threads; ++i)
+    workers.push_back(std::thread(&WorkerPool::workerLoop, this));
+}
+
+WorkerPool::~WorkerPool(){
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    stopping = true;
+  }
+  work_ready.notify_all();
+
+  for(unsigned i = 0; i < workers.size(); ++i)
+    workers[i].join();
+}
+
+unsigned WorkerPool::getNumThreads() const{
+  return workers.size() + 1;
+}
+
+// Runs one task of the current batch with the lock released.
+// Returns false when the batch has no tasks left to hand out.
+bool WorkerPool::runNextTask(std::unique_lock<std::mutex>& lock){
+  if(next_task >= num_tasks)
+    return false;
+
+  unsigned curr_task = next_task++;
+
+  lock.unlock();
+  task(curr_task);
+  lock.lock();
+
+  if(++tasks_done == num_tasks)
+    work_done.notify_all();
+
+  return true;
+}
+
+void WorkerPool::workerLoop(){
+  unsigned long long last_batch = 0;
+  std::unique_lock<std::mutex> lock(pool_mutex);
+
+  while(true){
+    while(!stopping && batch == last_batch)
+      work_ready.wait(lock);
+
+    if(stopping)
+      break;
+
+    last_batch = batch;
+    while(runNextTask(lock));
+  }
+}
+
+void WorkerPool::run(unsigned _num_tasks, const std::function<void(unsigned)>& fn){
+  if(_num_tasks == 0)
+    return;
+
+  if(workers.empty() || _num_tasks == 1){
+    for(unsigned i = 0; i < _num_tasks; ++i)
+      fn(i);
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(pool_mutex);
+  task = fn;
+  num_tasks = _num_tasks;
+  next_task = 0;
+  tasks_done = 0;
+  ++batch;
+  work_ready.notify_all();
+
+  while(runNextTask(lock));
+
+  while(tasks_done < num_tasks)
+    work_done.wait(lock);
+}
+
+#endif
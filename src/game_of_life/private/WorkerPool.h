@@ -0,0 +1,41 @@
+#ifndef _WORKER_POOL_H
+#define _WORKER_POOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// Fixed set of threads that run batches of independent tasks. The
+// calling thread takes part in every batch, so a pool of one thread
+// never spawns anything.
+class WorkerPool {
+  private:
+    std::vector<std::thread> workers;
+    std::mutex pool_mutex;
+    std::condition_variable work_ready;
+    std::condition_variable work_done;
+
+    std::function<void(unsigned)> task;
+    unsigned num_tasks;
+    unsigned next_task;
+    unsigned tasks_done;
+    unsigned long long batch;
+    bool stopping;
+
+    void workerLoop();
+    bool runNextTask(std::unique_lock<std::mutex>& lock);
+
+  public:
+    WorkerPool(unsigned num_threads = 1);
+    ~WorkerPool();
+
+    unsigned getNumThreads() const;
+
+    // Calls fn(0) .. fn(_num_tasks - 1) across the pool and
+    // returns once every call has finished.
+    void run(unsigned _num_tasks, const std::function<void(unsigned)>& fn);
+};
+
+#endif
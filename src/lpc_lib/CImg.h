@@ -3093,6 +3093,8 @@ namespace cimg_library_suffixed {
       bool is_blue_first;
       bool is_shm_enabled;
       bool byte_order;
+      void (*event_hook)(const XEvent *const, void *const); // Sees every input event before it's folded into the state
+      void *event_hook_data;
 
 #ifdef cimg_use_xrandr
       XRRScreenSize *resolutions;
@@ -3101,7 +3103,8 @@ namespace cimg_library_suffixed {
       unsigned int nb_resolutions;
 #endif
       X11_info():nb_wins(0),events_thread(0),display(0),
-                 nb_bits(0),is_blue_first(false),is_shm_enabled(false),byte_order(false) {
+                 nb_bits(0),is_blue_first(false),is_shm_enabled(false),byte_order(false),
+                 event_hook(0),event_hook_data(0) {
 #ifdef __FreeBSD__
         XInitThreads();
 #endif
@@ -9385,6 +9388,10 @@ namespace cimg_library_suffixed {
       pthread_mutex_unlock(&cimg::X11_attr().wait_event_mutex);
     }
 
+    void _call_event_hook(const XEvent& event) const {
+      if (cimg::X11_attr().event_hook) cimg::X11_attr().event_hook(&event,cimg::X11_attr().event_hook_data);
+    }
+
     void _handle_events(const XEvent *const pevent) {
       Display *const dpy = cimg::X11_attr().display;
       XEvent event = *pevent;
@@ -9424,6 +9431,7 @@ namespace cimg_library_suffixed {
       } break;
       case ButtonPress : {
         do {
+          _call_event_hook(event);
           _mouse_x = event.xmotion.x; _mouse_y = event.xmotion.y;
           if (_mouse_x<0 || _mouse_y<0 || _mouse_x>=width() || _mouse_y>=height()) _mouse_x = _mouse_y = -1;
           switch (event.xbutton.button) {
@@ -9435,6 +9443,7 @@ namespace cimg_library_suffixed {
       } break;
       case ButtonRelease : {
         do {
+          _call_event_hook(event);
           _mouse_x = event.xmotion.x; _mouse_y = event.xmotion.y;
           if (_mouse_x<0 || _mouse_y<0 || _mouse_x>=width() || _mouse_y>=height()) _mouse_x = _mouse_y = -1;
           switch (event.xbutton.button) {
@@ -9449,6 +9458,7 @@ namespace cimg_library_suffixed {
       case KeyPress : {
         char tmp = 0; KeySym ksym;
         XLookupString(&event.xkey,&tmp,1,&ksym,0);
+        _call_event_hook(event);
         set_key((unsigned int)ksym,true);
       } break;
       case KeyRelease : {
@@ -9457,6 +9467,7 @@ namespace cimg_library_suffixed {
         const unsigned int kc = event.xkey.keycode, kc1 = kc/8, kc2 = kc%8;
         const bool is_key_pressed = kc1>=32?false:(keys_return[kc1]>>kc2)&1;
         if (!is_key_pressed) {
+          _call_event_hook(event);
           char tmp = 0; KeySym ksym;
           XLookupString(&event.xkey,&tmp,1,&ksym,0);
           set_key((unsigned int)ksym,false);
@@ -9474,7 +9485,8 @@ namespace cimg_library_suffixed {
         pthread_cond_broadcast(&cimg::X11_attr().wait_event);
       } break;
       case MotionNotify : {
-        while (XCheckWindowEvent(dpy,_window,PointerMotionMask,&event)) {}
+        _call_event_hook(event);
+        while (XCheckWindowEvent(dpy,_window,PointerMotionMask,&event)) _call_event_hook(event);
         _mouse_x = event.xmotion.x;
         _mouse_y = event.xmotion.y;
         if (_mouse_x<0 || _mouse_y<0 || _mouse_x>=width() || _mouse_y>=height()) _mouse_x = _mouse_y = -1;
@@ -39,6 +39,12 @@
 #include <fstream>	// for ifstream
 #include <cstring>	// for strncmp
 #include <algorithm> 	// find, compare
+#include <vector>
+#include <map>
+#include <fcntl.h>	// for open
+#include <unistd.h>	// for close
+#include <sys/mman.h>	// for mmap
+#include <sys/stat.h>	// for fstat
 
 /* The dawg is stored as an array of edges. Each edge is represented by 
  * one 32-bit struct.  The 5 "letter" bits indicate the character on this 
@@ -49,8 +55,26 @@
  * the children of this node. The children are laid out contiguously in alphabetical order.
  * Since we read edges as binary bits from a file in a big-endian format, 
  * we have to swap the struct order for little-endian machines.
+ *
+ * The mapped format stores the same edges as little-endian words after a
+ * MappedHeader, which also holds the word count. On little-endian machines
+ * that is already the in-memory layout, so the file is mapped and used as is
+ * and loading never has to touch the edges.
  */
 
+struct MappedHeader {
+    char magic[8];		// "DAWGMAP" and a NUL
+    unsigned int version;
+    unsigned int startIndex;
+    unsigned int numEdges;
+    unsigned int numWords;
+};
+
+static const char MappedMagic[8] = "DAWGMAP";
+static const unsigned int MappedVersion = 1;
+static const unsigned int LastEdgeBit = 1 << 5, AcceptBit = 1 << 6;
+static const unsigned int MaxEdges = 1 << 24;	// children index is 24 bits
+
 
 Lexicon::Lexicon() 
 {
@@ -60,6 +84,8 @@ Lexicon::Lexicon()
     }
     edges = start = NULL;
     numEdges = numDawgWords = 0;
+    mapping = NULL;
+    mappingLen = 0;
 }
 
 
@@ -67,16 +93,17 @@ Lexicon::Lexicon(std::string filename)
 {
     edges = start = NULL;
     numEdges = numDawgWords = 0;
+    mapping = NULL;
+    mappingLen = 0;
     addWordsFromFile(filename);
 }
 
 Lexicon::~Lexicon() 
 {
-    if (edges) delete[] edges;
+    releaseDawg();
 }
 
-#if defined(BYTE_ORDER) && BYTE_ORDER == LITTLE_ENDIAN
-// swaps a 4-byte int from big to little endian byte order
+// swaps a 4-byte int between big and little endian byte order
 static unsigned int my_ntohl(unsigned int arg)
 {
     unsigned int result =  ((arg & 0xff000000) >> 24) |
@@ -85,7 +112,27 @@ static unsigned int my_ntohl(unsigned int arg)
 	((arg & 0x000000ff) << 24);
     return result;
 }
+
+// converts between host order and the mapped format's little-endian words
+static unsigned int my_htole(unsigned int arg)
+{
+#if defined(BYTE_ORDER) && BYTE_ORDER == LITTLE_ENDIAN
+    return arg;
+#else
+    return my_ntohl(arg);
 #endif
+}
+
+// Frees or unmaps the dawg, whichever way it was loaded
+void Lexicon::releaseDawg()
+{
+    if (mapping) munmap(mapping, mappingLen);
+    else if (edges) delete[] edges;
+    edges = start = NULL;
+    mapping = NULL;
+    mappingLen = 0;
+    numEdges = numDawgWords = 0;
+}
 
 static void CountWord(std::string word, int &count) { count++; }
 
@@ -109,6 +156,7 @@ void Lexicon::readBinaryFile(std::string filename)
     if (istr.fail() || strncmp(firstFour, expected, 4) != 0 || startIndex < 0 || numBytes < 0)
 	Error("Improperly formed lexicon file " + filename);
 
+    releaseDawg();
     numEdges = numBytes/sizeof(Edge);
     edges = new Edge[numEdges];
     start = &edges[startIndex];
@@ -126,22 +174,150 @@ void Lexicon::readBinaryFile(std::string filename)
     recMapAll(start, true, "", CountWord, numDawgWords);
 }
 
-// Check for DAWG in first 4 to identify as special binary format,
-// otherwise assume ascii, one word per line
+// Mapped lexicon file format is a MappedHeader followed by numEdges
+// little-endian edges. The whole file is mapped read-only and the word
+// count comes from the header, so nothing is read until it's searched.
+void Lexicon::readMappedFile(std::string filename)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+	Error("Couldn't open lexicon file " + filename);
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size < (off_t) sizeof(MappedHeader)) {
+	close(fd);
+	Error("Improperly formed lexicon file " + filename);
+    }
+
+    void *map = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+	Error("Couldn't map lexicon file " + filename);
+
+    MappedHeader header;
+    memcpy(&header, map, sizeof(header));
+    unsigned int numFileEdges = my_htole(header.numEdges);
+    unsigned int startIndex = my_htole(header.startIndex);
+    if (memcmp(header.magic, MappedMagic, sizeof(MappedMagic)) != 0 ||
+	my_htole(header.version) != MappedVersion || numFileEdges > MaxEdges ||
+	(startIndex >= numFileEdges && header.numWords != 0) ||
+	sizeof(MappedHeader) + (size_t) numFileEdges * sizeof(Edge) > (size_t) fileStat.st_size) {
+	munmap(map, fileStat.st_size);
+	Error("Improperly formed lexicon file " + filename);
+    }
+
+    releaseDawg();
+    numEdges = numFileEdges;
+    numDawgWords = my_htole(header.numWords);
+#if defined(BYTE_ORDER) && BYTE_ORDER == LITTLE_ENDIAN
+    // lookups hop around the graph, so don't read ahead
+    madvise(map, fileStat.st_size, MADV_RANDOM);
+    mapping = map;
+    mappingLen = fileStat.st_size;
+    edges = (Edge *)((char *) map + sizeof(MappedHeader));
+#else
+    edges = new Edge[numEdges];
+    memcpy(edges, (char *) map + sizeof(MappedHeader), numEdges * sizeof(Edge));
+    unsigned int *cur = (unsigned int *)edges;
+    for (int i = 0; i < numEdges; i++, cur++)
+	*cur = my_htole(*cur);
+    munmap(map, fileStat.st_size);
+#endif
+    start = numDawgWords ? &edges[startIndex] : NULL;
+}
+
+static void CollectWord(std::string word, std::vector<std::string> &words) { words.push_back(word); }
+
+// Lays out the children of the words in [lo, hi) that share their first depth
+// letters and returns the index of the first child edge, or 0 if there are none.
+// Children are laid out before their parents, and a list of children that's
+// already been laid out is reused, which merges the common suffixes.
+static unsigned int LayOutChildren(const std::vector<std::string> &words, size_t lo, size_t hi, size_t depth,
+				   std::vector<unsigned int> &out, std::map<std::vector<unsigned int>, unsigned int> &lists)
+{
+    std::vector<unsigned int> list;
+    size_t i = lo;
+    while (i < hi) {
+	if (words[i].length() == depth) {	// ends here, the parent edge accepts it
+	    i++;
+	    continue;
+	}
+	char ch = words[i][depth];
+	if (ch < 'a' || ch > 'z')
+	    Error("Lexicon word can't be stored in a dawg: " + words[i]);
+	size_t j = i;
+	bool accept = false;
+	while (j < hi && words[j][depth] == ch) {
+	    if (words[j].length() == depth + 1) accept = true;
+	    j++;
+	}
+	unsigned int children = LayOutChildren(words, i, j, depth + 1, out, lists);
+	list.push_back((ch - 'a' + 1) | (accept ? AcceptBit : 0) | (children << 8));
+	i = j;
+    }
+    if (list.empty()) return 0;
+    list.back() |= LastEdgeBit;
+
+    std::map<std::vector<unsigned int>, unsigned int>::iterator itr = lists.find(list);
+    if (itr != lists.end()) return itr->second;
+    if (out.size() + list.size() > MaxEdges)
+	Error("Too many words to store in a dawg");
+    unsigned int index = (unsigned int) out.size();
+    out.insert(out.end(), list.begin(), list.end());
+    lists[list] = index;
+    return index;
+}
+
+void Lexicon::writeMappedFile(std::string filename)
+{
+    std::vector<std::string> words;
+    mapAll(CollectWord, words);
+    sort(words.begin(), words.end());
+
+    // edge 0 is never a child list, children == 0 means no children
+    std::vector<unsigned int> out(1, 0);
+    std::map<std::vector<unsigned int>, unsigned int> lists;
+    unsigned int startIndex = LayOutChildren(words, 0, words.size(), 0, out, lists);
+
+    MappedHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MappedMagic, sizeof(MappedMagic));
+    header.version = my_htole(MappedVersion);
+    header.startIndex = my_htole(startIndex);
+    header.numEdges = my_htole((unsigned int) out.size());
+    header.numWords = my_htole((unsigned int) words.size());
+    for (size_t i = 0; i < out.size(); i++)
+	out[i] = my_htole(out[i]);
+
+    std::ofstream ostr(filename.c_str(), std::ios::out|std::ios::binary|std::ios::trunc);
+    ostr.write((const char *) &header, sizeof(header));
+    ostr.write((const char *) &out[0], out.size() * sizeof(unsigned int));
+    ostr.close();
+    if (ostr.fail())
+	Error("Couldn't write lexicon file " + filename);
+}
+
+// Check for DAWGMAP or DAWG at the start to identify as one of the special
+// binary formats, otherwise assume ascii, one word per line
 void Lexicon::addWordsFromFile(std::string filename) 
 {
-    char firstFour[4], expected[] = "DAWG";
-    std::ifstream istr(filename.c_str());
+    char firstEight[8], expected[] = "DAWG";
+    std::ifstream istr(filename.c_str(), std::ios::in|std::ios::binary);
 
     if (istr.fail())
 	Error("Couldn't open lexicon file " + filename);
 
-    istr.read(firstFour, 4);
-    if (strncmp(firstFour, expected, 4) == 0) {
+    istr.read(firstEight, 8);
+    if (istr.gcount() == 8 && memcmp(firstEight, MappedMagic, 8) == 0) {
+	readMappedFile(filename);
+	return;
+    }
+    if (istr.gcount() >= 4 && strncmp(firstEight, expected, 4) == 0) {
 	readBinaryFile(filename);
 	return;
     }
 
+    istr.clear();
     istr.seekg(0);	// return back to beginning
     std::string line;
     while (getline(istr, line))
@@ -162,9 +338,7 @@ bool Lexicon::isEmpty()
 
 void Lexicon::clear() 
 {
-    if (edges) delete[] edges;
-    edges = start = NULL;
-    numEdges = numDawgWords = 0;
+    releaseDawg();
     otherWords.clear();
 }
 
@@ -248,7 +422,7 @@ Lexicon::Lexicon(const Lexicon &rhs)
 const Lexicon & Lexicon::operator=(const Lexicon &rhs)
 {
     if (this != &rhs) {
-	delete[] edges;
+	releaseDawg();
 	copyContentsFrom(rhs);			
     }
     return *this;
@@ -256,6 +430,8 @@ const Lexicon & Lexicon::operator=(const Lexicon &rhs)
 
 void Lexicon::copyContentsFrom(const Lexicon &rhs)
 {
+    mapping = NULL;	// a copy always owns its edges
+    mappingLen = 0;
     if (rhs.edges != NULL && rhs.numEdges != 0) {
         numEdges = rhs.numEdges;
         edges = new Edge[rhs.numEdges];
@@ -109,6 +109,18 @@ class Lexicon {
     */
 	void addWordsFromFile(std::string filename);
 
+   /*
+    * Member function: writeMappedFile
+    * Usage: lex.writeMappedFile("patterns.dawg");
+    * --------------------------------------------
+    * This member function saves every word in this lexicon as a dawg in the
+    * mapped binary format. Reading that file back maps it into memory and
+    * uses it in place, so loading costs the same however many words it holds.
+    * Only the letters a-z can be stored in a dawg. If a word has any other
+    * character or the file can't be written, Error is called to exit the program.
+    */
+	void writeMappedFile(std::string filename);
+
 
    /*
     * Member function: containsWord
@@ -202,11 +214,15 @@ class Lexicon {
 
     Edge *edges, *start;
     int numEdges, numDawgWords;
+    void *mapping;		// edges points into this when the dawg is mapped
+    size_t mappingLen;
     std::set<std::string> otherWords;
 
     Edge *findEdgeForChar(Edge *children, char ch);
     Edge *traceToLastEdge(const std::string & s);
     void readBinaryFile(std::string filename);
+    void readMappedFile(std::string filename);
+    void releaseDawg();
 	template <typename ClientDataType>
 	  void recMapAll(Edge *edge, bool first, std::string soFar, void (fn)(std::string, ClientDataType &), ClientDataType &data);
 
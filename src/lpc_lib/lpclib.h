@@ -36,6 +36,18 @@ private:
     friend class GraphicsWindow;
 };
 
+/// A single mouse or key event, time is in seconds on the steady clock
+struct InputEvent
+{
+    enum Type { MouseDown, MouseUp, MouseMove, KeyDown, KeyUp };
+
+    Type type;
+    int x;
+    int y;
+    unsigned int key;
+    double time;
+};
+
 struct GWImpl;
 class GraphicsWindow
 {
@@ -61,6 +73,15 @@ public:
     
     char WaitForKeyPress();
     bool KeyPressed(std::string key);
+
+    /// Sleeps until the next input event or until timeout seconds
+    /// have passed (a negative timeout waits forever). Returns false
+    /// if it timed out.
+    bool WaitForEvent(InputEvent & event, double timeout = -1);
+
+    /// Takes the next queued input event without waiting. Events are
+    /// queued in the background, so none are lost between calls.
+    bool PollEvent(InputEvent & event);
     
     void Pause(double seconds);
     
@@ -13,6 +13,11 @@
 #include <iostream>
 #include <map>
 #include <vector>
+#include <deque>
+#include <chrono>
+#include <ctime>
+#include <mutex>
+#include <condition_variable>
 #include "CImg.h"
 #include "lpclib.h"
 using namespace cimg_library;
@@ -33,8 +38,19 @@ struct GWImpl
     std::map<std::string, CImg<unsigned char> *> imagemap;
     CImgDisplay * gdisplay;
     CImg<unsigned char> * gpixels;
+
+    // Every X11 input event is queued by CImg's event thread as it
+    // arrives, so slow frames don't lose events. The pointer position
+    // is the one of the last event queued.
+    int mouse_x;
+    int mouse_y;
+    std::deque<InputEvent> pending;
+    std::mutex event_mutex;
+    std::condition_variable event_ready;
 };
 
+static void QueueXEvent(const XEvent * const xevent, void * const data);
+
 Color::Color(unsigned char r, unsigned char g, unsigned char b)
 {
     _priv = new ColImpl;
@@ -56,6 +72,13 @@ GraphicsWindow::GraphicsWindow(int width, int height, std::string title)
     _priv->gdisplay = new CImgDisplay(*(_priv->gpixels), title.c_str());
     _priv->gpixels->display(*(_priv->gdisplay));
 
+    _priv->mouse_x = _priv->mouse_y = -1;
+
+    cimg_lock_display();
+    cimg::X11_attr().event_hook = QueueXEvent;
+    cimg::X11_attr().event_hook_data = _priv;
+    cimg_unlock_display();
+
     if (_priv->gdisplay->window_width() != width)
         Err("Requested width " + IntToString(width) + " does not fit the screen.");
     if (_priv->gdisplay->height() != height)
@@ -64,6 +87,10 @@ GraphicsWindow::GraphicsWindow(int width, int height, std::string title)
 
 GraphicsWindow::~GraphicsWindow()
 {
+    cimg_lock_display();
+    cimg::X11_attr().event_hook = 0;
+    cimg::X11_attr().event_hook_data = 0;
+    cimg_unlock_display();
     delete _priv;
 }
 
@@ -234,5 +261,116 @@ std::string GraphicsWindow::WhatKey()
     return s;
 }
 
+static double SteadyNow()
+{
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void QueueEvent(GWImpl * priv, InputEvent::Type type, unsigned int key, double now)
+{
+    InputEvent event;
+    event.type = type;
+    event.x = priv->mouse_x;
+    event.y = priv->mouse_y;
+    event.key = key;
+    event.time = now;
+    priv->pending.push_back(event);
+}
 
+/// Called by CImg's event thread, display locked, with each press,
+/// release, motion and key event of the window before CImg folds it
+/// into the display state. Every one is queued, so a click is never
+/// lost however quickly it's over.
+static void QueueXEvent(const XEvent * const xevent, void * const data)
+{
+    GWImpl * priv = (GWImpl *)data;
+    CImgDisplay * disp = priv->gdisplay;
+    if (xevent->xany.window != disp->_window)
+        return;
 
+    double now = SteadyNow();
+    std::lock_guard<std::mutex> lock(priv->event_mutex);
+
+    switch (xevent->type)
+    {
+        case ButtonPress:
+        case ButtonRelease:
+        case MotionNotify:
+        {
+            // off the window is -1, as CImg reports it
+            int x = xevent->xmotion.x, y = xevent->xmotion.y;
+            if (x < 0 || y < 0 || x >= disp->width() || y >= disp->height())
+                x = y = -1;
+
+            if (xevent->type == MotionNotify)
+            {
+                if (x == priv->mouse_x && y == priv->mouse_y)
+                    return;
+                priv->mouse_x = x;
+                priv->mouse_y = y;
+                QueueEvent(priv, InputEvent::MouseMove, 0, now);
+                break;
+            }
+
+            // buttons 4 and 5 are the wheel
+            if (xevent->xbutton.button > 3)
+                return;
+            priv->mouse_x = x;
+            priv->mouse_y = y;
+            QueueEvent(priv, xevent->type == ButtonPress ? InputEvent::MouseDown : InputEvent::MouseUp,
+                       0, now);
+            break;
+        }
+
+        case KeyPress:
+        case KeyRelease:
+        {
+            char text = 0;
+            KeySym ksym;
+            XLookupString((XKeyEvent *)&xevent->xkey, &text, 1, &ksym, 0);
+            QueueEvent(priv, xevent->type == KeyPress ? InputEvent::KeyDown : InputEvent::KeyUp,
+                       (unsigned int)ksym, now);
+            break;
+        }
+
+        default:
+            return;
+    }
+
+    priv->event_ready.notify_all();
+}
+
+bool GraphicsWindow::WaitForEvent(InputEvent & event, double timeout)
+{
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() +
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(timeout));
+    std::unique_lock<std::mutex> lock(_priv->event_mutex);
+
+    while (_priv->pending.empty())
+    {
+        if (timeout < 0)
+            _priv->event_ready.wait(lock);
+        else if (_priv->event_ready.wait_until(lock, deadline) == std::cv_status::timeout)
+            break;
+    }
+
+    if (_priv->pending.empty())
+        return false;
+
+    event = _priv->pending.front();
+    _priv->pending.pop_front();
+    return true;
+}
+
+bool GraphicsWindow::PollEvent(InputEvent & event)
+{
+    std::unique_lock<std::mutex> lock(_priv->event_mutex);
+
+    if (_priv->pending.empty())
+        return false;
+
+    event = _priv->pending.front();
+    _priv->pending.pop_front();
+    return true;
+}
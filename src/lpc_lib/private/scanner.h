@@ -19,8 +19,12 @@
 	};
 
 	string buffer;
-	int len; // buflen; in the original
-	int cp;
+	const char *data; // buffer's characters or the mapped file
+	size_t len; // buflen; in the original
+	size_t cp;
+	void *mapping;
+	size_t mappingLen;
+	string heldToken; // a token from saveToken while its view is out
 	istream *fp;
 	spaceOptionT spaceOption;
 	numberOptionT numberOption;
@@ -28,10 +32,11 @@
 	bracketOptionT bracketOption;
 	stack<string> savedTokens;
 
+	void releaseMapping();
 	void skipSpaces();
-	int scanToEndOfIdentifier();
-	int scanToEndOfInteger();
-	int scanToEndOfReal();
-	string scanQuotedString();
+	size_t scanToEndOfIdentifier();
+	size_t scanToEndOfInteger();
+	size_t scanToEndOfReal();
+	string_view scanQuotedString();
 	// char scanEscapeCharacter(); NOT IMPLEMENTED IN THIS VERSION
-	string scanTag();
+	string_view scanTag();
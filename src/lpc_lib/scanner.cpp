@@ -11,6 +11,11 @@
 #include <cctype>
 #include <cstdlib>
 #include <iostream>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 enum inputSymbolType { isaDigit = 0, isaPoint, isaPlusMinus, isanE, isOther };
 
@@ -19,41 +24,79 @@ enum inputSymbolType { isaDigit = 0, isaPoint, isaPlusMinus, isanE, isOther };
  * but consist of the following fields:
  *
  * buffer -- String passed to setInput
- * len -- Length of buffer, saved for efficiency
- * cp -- Current character position in the buffer
+ * data -- The characters being scanned, buffer's or a mapped file's
+ * len -- Length of data, saved for efficiency
+ * cp -- Current character position in data
+ * mapping -- The mapped file from setInputFile, if any
  * spaceOption -- Setting of the space option extension
  */
 
 Scanner::Scanner() {
     buffer = "";
+    data = NULL;
+    len = cp = 0;
+    mapping = NULL;
+    mappingLen = 0;
     spaceOption = PreserveSpaces;
     numberOption = ScanNumbersAsLetters;
+    stringOption = ScanQuotesAsPunctuation;
+    bracketOption = ScanBracketsAsPunctuation;
 }
 
 Scanner::~Scanner() {
-    /* Empty */
+    releaseMapping();
 }
 
 void Scanner::setInput(string str) {
+    releaseMapping();
     buffer = str;
-    len = (int) buffer.length();
+    data = buffer.data();
+    len = buffer.length();
     cp = 0;
 }
 
 void Scanner::setInput(istream & infile)
 {
-    string tempbuffer = "";
-    char onechar;
+    ostringstream contents;
     infile.clear();
     infile.seekg(0);
-    while (1)
-    {
-        infile.read(&onechar, 1);
-        if (!infile)
-            break;
-        tempbuffer += onechar;
+    contents << infile.rdbuf();
+    setInput(contents.str());
+}
+
+bool Scanner::setInputFile(string filename)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0) {
+        close(fd);
+        return false;
     }
-    setInput(tempbuffer);
+
+    // an empty file can't be mapped, scan an empty string instead
+    if (fileStat.st_size == 0) {
+        close(fd);
+        setInput("");
+        return true;
+    }
+
+    void *map = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return false;
+
+    // the whole file is read front to back
+    madvise(map, fileStat.st_size, MADV_SEQUENTIAL);
+
+    setInput("");
+    mapping = map;
+    mappingLen = fileStat.st_size;
+    data = (const char *) map;
+    len = mappingLen;
+    return true;
 }
 
 /*
@@ -63,47 +106,51 @@ void Scanner::setInput(istream & infile)
  */
 
 string Scanner::nextToken() {
-    if (cp == -1) {
+    return string(nextTokenView());
+}
+
+string_view Scanner::nextTokenView() {
+    if (data == NULL) {
         Error("setInput has not been called");
     }
     if (! savedTokens.empty())
     {
-        string topToken = savedTokens.top();
+        heldToken = savedTokens.top();
         savedTokens.pop();
-        return topToken;
+        return heldToken;
     }
 
     if (spaceOption == IgnoreSpaces) skipSpaces();
-    int start = cp;
-    if (start >= len) return "";
-    if (stringOption == ScanQuotesAsStrings && buffer[cp] == '\"')
+    size_t start = cp;
+    if (start >= len) return string_view();
+    if (stringOption == ScanQuotesAsStrings && data[cp] == '\"')
     {
         return (scanQuotedString());
     }
-    else if (bracketOption == ScanBracketsAsTag && buffer[cp] == '<')
+    else if (bracketOption == ScanBracketsAsTag && data[cp] == '<')
     {
         return (scanTag());
     }
-    else if (isdigit(buffer[cp]) && numberOption != ScanNumbersAsLetters)
+    else if (isdigit(data[cp]) && numberOption != ScanNumbersAsLetters)
     {
-        int finish;
+        size_t finish;
         if (numberOption == ScanNumbersAsIntegers)
             finish = scanToEndOfInteger();
-        else if (numberOption == ScanNumbersAsReals)
+        else
             finish = scanToEndOfReal();
-        return buffer.substr(start, finish - start + 1);
+        return string_view(data + start, finish - start + 1);
     }
-    else if (isalnum(buffer[cp]))
+    else if (isalnum(data[cp]))
     {
-        int finish = scanToEndOfIdentifier();
-        return buffer.substr(start, finish - start + 1);
+        size_t finish = scanToEndOfIdentifier();
+        return string_view(data + start, finish - start + 1);
     }
     cp++;
-    return buffer.substr(start, 1);
+    return string_view(data + start, 1);
 }
 
 bool Scanner::hasMoreTokens() {
-    if (cp == -1) {
+    if (data == NULL) {
         Error("setInput has not been called");
     }
     if (spaceOption == IgnoreSpaces) skipSpaces();
@@ -152,6 +199,21 @@ Scanner::bracketOptionT Scanner::getBracketOption()
 
 /* Private functions */
 
+/*
+ * Private method: releaseMapping
+ * Usage: releaseMapping();
+ * ------------------------
+ * This function unmaps the file from setInputFile, if there is one.
+ */
+
+void Scanner::releaseMapping() {
+    if (mapping != NULL) {
+        munmap(mapping, mappingLen);
+        mapping = NULL;
+        mappingLen = 0;
+    }
+}
+
 /*
  * Private method: skipSpaces
  * Usage: skipSpaces();
@@ -161,7 +223,7 @@ Scanner::bracketOptionT Scanner::getBracketOption()
  */
 
 void Scanner::skipSpaces() {
-    while (cp < len && isspace(buffer[cp])) {
+    while (cp < len && isspace(data[cp])) {
         cp++;
     }
 }
@@ -177,34 +239,33 @@ void Scanner::skipSpaces() {
  * cp is the first character after that.
  */
 
-int Scanner::scanToEndOfIdentifier() {
-    while (cp < len && isalnum(buffer[cp])) {
+size_t Scanner::scanToEndOfIdentifier() {
+    while (cp < len && isalnum(data[cp])) {
         cp++;
     }
     return cp - 1;
 }
 
-int Scanner::scanToEndOfInteger()
+size_t Scanner::scanToEndOfInteger()
 {
-    while (cp < len && isdigit(buffer[cp])) {
+    while (cp < len && isdigit(data[cp])) {
         cp++;
     }
     return cp - 1;
 }
 
-string Scanner::scanQuotedString()
+string_view Scanner::scanQuotedString()
 {
-    string result = "";
+    size_t start = cp;
     do
     {
-        result += buffer[cp];
         cp++;
     }
-    while (cp < len && buffer[cp] != '\"');
-    if (buffer[cp] != '\"')
+    while (cp < len && data[cp] != '\"');
+    if (cp >= len)
         Error("Unmatched \" in scanner input");
     cp++;
-    return result + "\"";
+    return string_view(data + start, cp - start);
 }
 
 static inputSymbolType CategorizeSymbol(char c)
@@ -222,7 +283,7 @@ static inputSymbolType CategorizeSymbol(char c)
 }
 
 
-int Scanner::scanToEndOfReal()
+size_t Scanner::scanToEndOfReal()
 {
     // -- Finite State Machine represented as a table --
     // rows are states
@@ -243,7 +304,7 @@ int Scanner::scanToEndOfReal()
 
     do
     {
-        int category = CategorizeSymbol(buffer[cp]);
+        int category = CategorizeSymbol(data[cp]);
         if (category == isOther)
             state = FinalState;
         else
@@ -256,19 +317,18 @@ int Scanner::scanToEndOfReal()
     return (cp - 1);
 }
 
-string Scanner::scanTag()
+string_view Scanner::scanTag()
 {
-    string result = "";
+    size_t start = cp;
     do
     {
-        result += buffer[cp];
         cp++;
     }
-    while (cp < len && buffer[cp] != '>');
-    if (buffer[cp] != '>')
+    while (cp < len && data[cp] != '>');
+    if (cp >= len)
         Error("Unmatched < in scanner input");
     cp++;
-    return result + ">";
+    return string_view(data + start, cp - start);
 }
 
 
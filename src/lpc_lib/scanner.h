@@ -52,6 +52,13 @@
  * particular object name before the "." in a method call to
  * identify which particular instance of the scanner is to be used.
  *
+ * Large files can be scanned in place with
+ *
+ *      scanner.setInputFile(filename);
+ *
+ * which maps the file rather than copying it, and nextTokenView
+ * returns each token as a string_view without allocating.
+ *
  * The Scanner class also supports the following advanced features,
  * which are documented later in the interface:
  *
@@ -67,6 +74,7 @@
 
 #include <stack>
 #include <string>
+#include <string_view>
 #include <iostream>
 using namespace std;
 
@@ -118,6 +126,17 @@ public:
  */
 	void setInput(istream & infile);
 
+/*
+ * Method: setInputFile
+ * Usage: if (scanner.setInputFile(filename)) . . .
+ * -------------------------------------------------
+ * This method maps the named file read-only and scans it in
+ * place, so nothing is copied no matter how large it is.  It
+ * returns false if the file can't be opened or mapped.  Any
+ * previous input is discarded.
+ */
+	bool setInputFile(string filename);
+
 /*
  * Method: nextToken
  * Usage: token = scanner.nextToken();
@@ -128,6 +147,17 @@ public:
  */
 	string nextToken();
 
+/*
+ * Method: nextTokenView
+ * Usage: string_view token = scanner.nextTokenView();
+ * ---------------------------------------------------
+ * This method works like nextToken, but returns a view of the
+ * token inside the scanner's input instead of a copy.  The view
+ * stays valid until the input changes, except for a token put back
+ * with saveToken, which is only valid until the next call.
+ */
+	string_view nextTokenView();
+
 /*
  * Method: hasMoreTokens
  * Usage: if (scanner.hasMoreTokens()) . . .
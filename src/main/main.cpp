@@ -3,10 +3,45 @@
  * Assignment: PA5
  */
 
+#include <string>
+#include <cstdint>
+#include "../lpc_lib/lpclib.h"
 #include "../game_of_life/GameOfLife.h"
+#include "../game_of_life/BatchRun.h"
+#include "../game_of_life/GliderCollide.h"
+#include "../game_of_life/LifeEnsemble.h"
+#include "../game_of_life/PredecessorSearch.h"
+#include "../game_of_life/RuleSurvey.h"
+#include "../game_of_life/SoupCensus.h"
 
-int main(){
-  GameOfLife game;
+int main(int argc, char* argv[]){
+  size_t history_budget = DEFAULT_HISTORY_BUDGET;
+
+  // "--history <MB>" alone sets the window's step-back memory,
+  // "census" runs soups, "ensemble" benchmarks ensemble stepping,
+  // "collide" searches glider collisions, "parents" searches for a
+  // pattern's parent, "survey" runs a board under many rules and any
+  // other arguments select the headless batch mode
+  if(argc == 3 && std::string(argv[1]) == "--history"){
+    unsigned long long megabytes = parseCount(argv[1], argv[2]);
+    if(megabytes == 0 || megabytes > (SIZE_MAX >> 20))
+      Error("Bad value for --history: " + std::string(argv[2]));
+    history_budget = megabytes << 20;
+  }
+  else if(argc > 1 && std::string(argv[1]) == "census")
+    return runCensus(argc, argv);
+  else if(argc > 1 && std::string(argv[1]) == "ensemble")
+    return runEnsemble(argc, argv);
+  else if(argc > 1 && std::string(argv[1]) == "collide")
+    return runCollide(argc, argv);
+  else if(argc > 1 && std::string(argv[1]) == "parents")
+    return runParents(argc, argv);
+  else if(argc > 1 && std::string(argv[1]) == "survey")
+    return runSurvey(argc, argv);
+  else if(argc > 1)
+    return runBatch(argc, argv);
+
+  GameOfLife game(history_budget);
 
   game.run();
 }